@@ -0,0 +1,244 @@
+#ifndef fitIndexUtils_h
+#define fitIndexUtils_h
+
+#include "TSystem.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "ROOT/TProcessExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+
+#include "RooWorkspace.h"
+#include "RooRealVar.h"
+#include "RooAbsPdf.h"
+#include "RooArgSet.h"
+#include "RooStringVar.h"
+#include "RooFitResult.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cmath>
+
+#include "../../../Utilities/dataUtils.h"
+
+
+// Index of the fit outputs stored in a result directory, keyed by file name
+//   Var  : Min, Max and Val of each fitted variable, and nll, npar and status
+//   Par  : fileName, filePath, fileStamp and pdfName
+typedef std::map< std::string , GlobalInfo > FitIndex_t;
+
+
+bool extractFitInfo ( GlobalInfo& info , const std::string& filePath );
+bool saveFitIndex   ( const std::string& fileName , const FitIndex_t& index );
+bool loadFitIndex   ( FitIndex_t& index , const std::string& fileName );
+bool getFitIndex    ( FitIndex_t& index , const std::string& dirPath , const uint& nCores=4 );
+template <class B> B    getFitIndexBin  ( const GlobalInfo& info , const StringVector_t& obsList );
+template <class B> bool getFitIndexBins ( std::map< B , GlobalInfo >& content , const std::string& dirPath , const StringVector_t& obsList , const uint& nCores=4 );
+
+
+bool extractFitInfo(GlobalInfo& info, const std::string& filePath)
+{
+  std::string pdfName = "";
+  double npar = -1., status = -1.;
+  // Use the fit summary if available
+  FitSummary_t summary;
+  if (getFitSummary(summary, filePath)) {
+    for (const auto& r : summary) {
+      if (r.kind=="VAR") {
+	info.Var[r.name]["Min"] = r.min;
+	info.Var[r.name]["Max"] = r.max;
+	info.Var[r.name]["Val"] = r.val;
+      }
+      else if (r.kind=="STR" && r.name=="pdfName") { pdfName = r.str; }
+      else if (r.kind=="FIT" && r.name=="status") { status = r.val; }
+    }
+    for (const auto& r : summary) { if (r.kind=="PDF" && r.name==pdfName) { npar = r.iniVal; } }
+  }
+  else {
+    // Open the input file
+    TFile inputFile(filePath.c_str(), "READ");
+    if (!inputFile.IsOpen() || inputFile.IsZombie()) { std::cout << "[ERROR] The input file " << filePath << " was not opened!" << std::endl; return false; }
+    inputFile.cd();
+    // Extract the workspace
+    const auto& ws = dynamic_cast<RooWorkspace*>(inputFile.Get("workspace"));
+    if (!ws) { std::cout << "[ERROR] Workspace not found in " << filePath << std::endl; inputFile.Close(); return false; }
+    // Get variables
+    auto vars = ws->allVars();
+    auto varIt = std::unique_ptr<TIterator>(vars.createIterator());
+    for (auto itp = varIt->Next(); itp!=NULL; itp = varIt->Next()) {
+      const auto& it = dynamic_cast<RooRealVar*>(itp); if (!it) continue;
+      const std::string& name = it->GetName();
+      info.Var[name]["Min"] = it->getMin();
+      info.Var[name]["Max"] = it->getMax();
+      info.Var[name]["Val"] = it->getVal();
+    }
+    // Get PDF info
+    pdfName = (ws->obj("pdfName") ? dynamic_cast<RooStringVar*>(ws->obj("pdfName"))->getVal() : "");
+    if (ws->pdf(pdfName.c_str()) && ws->var("Cand_Mass")) {
+      auto pars = std::unique_ptr<RooArgSet>(ws->pdf(pdfName.c_str())->getParameters(*ws->var("Cand_Mass")));
+      if (pars) { npar = pars->getSize(); }
+    }
+    // Get the fit status
+    for (const auto& ito : ws->allGenericObjects()) {
+      const auto& it = dynamic_cast<RooFitResult*>(ito); if (it) { status = it->status(); break; }
+    }
+    inputFile.Close();
+  }
+  // Store the fit information
+  info.Par["pdfName"] = pdfName;
+  info.Var["npar"]["Val"] = npar;
+  info.Var["status"]["Val"] = status;
+  if (contain(info.Var, "NLL_"+pdfName)) { info.Var["nll"]["Val"] = info.Var.at("NLL_"+pdfName).at("Val"); }
+  return true;
+};
+
+
+bool saveFitIndex(const std::string& fileName, const FitIndex_t& index)
+{
+  // Write to a temporary file first, so that concurrent jobs never read a partial index
+  const auto& tmpName = fileName + Form(".%d.tmp", gSystem->GetPid());
+  auto file = std::unique_ptr<TFile>(TFile::Open(tmpName.c_str(), "RECREATE"));
+  if (!file || !file->IsOpen() || file->IsZombie()) { std::cout << "[ERROR] Failed to create the fit index file: " << fileName << std::endl; return false; }
+  file->cd();
+  TTree tree("fitIndex", "fitIndex");
+  std::string name;
+  std::vector<std::string> varName, varType, parName, parVal;
+  std::vector<double> varVal;
+  tree.Branch("name", &name);
+  tree.Branch("varName", &varName); tree.Branch("varType", &varType); tree.Branch("varVal", &varVal);
+  tree.Branch("parName", &parName); tree.Branch("parVal", &parVal);
+  for (const auto& f : index) {
+    name = f.first;
+    varName.clear(); varType.clear(); varVal.clear(); parName.clear(); parVal.clear();
+    for (const auto& v : f.second.Var) {
+      for (const auto& t : v.second) { varName.push_back(v.first); varType.push_back(t.first); varVal.push_back(t.second); }
+    }
+    for (const auto& p : f.second.Par) { parName.push_back(p.first); parVal.push_back(p.second); }
+    tree.Fill();
+  }
+  tree.Write();
+  file->Close();
+  if (gSystem->Rename(tmpName.c_str(), fileName.c_str())!=0) { std::cout << "[ERROR] Failed to store the fit index file: " << fileName << std::endl; return false; }
+  return true;
+};
+
+
+bool loadFitIndex(FitIndex_t& index, const std::string& fileName)
+{
+  auto file = std::unique_ptr<TFile>(TFile::Open(fileName.c_str(), "READ"));
+  if (!file || !file->IsOpen() || file->IsZombie()) { return false; }
+  auto tree = dynamic_cast<TTree*>(file->Get("fitIndex"));
+  if (!tree) { return false; }
+  std::string *name=0;
+  std::vector<std::string> *varName=0, *varType=0, *parName=0, *parVal=0;
+  std::vector<double> *varVal=0;
+  tree->SetBranchAddress("name", &name);
+  tree->SetBranchAddress("varName", &varName); tree->SetBranchAddress("varType", &varType); tree->SetBranchAddress("varVal", &varVal);
+  tree->SetBranchAddress("parName", &parName); tree->SetBranchAddress("parVal", &parVal);
+  for (Long64_t i = 0; i < tree->GetEntries(); i++) {
+    if (tree->GetEntry(i)<0) { return false; }
+    auto& info = index[*name];
+    for (uint j = 0; j < varName->size(); j++) { info.Var[varName->at(j)][varType->at(j)] = varVal->at(j); }
+    for (uint j = 0; j < parName->size(); j++) { info.Par[parName->at(j)] = parVal->at(j); }
+  }
+  file->Close();
+  return true;
+};
+
+
+bool getFitIndex(FitIndex_t& index, const std::string& dirPath, const uint& nCores)
+{
+  const auto& resultDir = dirPath + "result/";
+  const auto& indexFile = dirPath + "fitIndex.root";
+  // Find the fit output files
+  StringVector_t fileNames;
+  if (!fileList(fileNames, resultDir, false)) { return false; }
+  // Load the stored index
+  FitIndex_t cache;
+  if (existFile(indexFile) && !loadFitIndex(cache, indexFile)) {
+    std::cout << "[WARNING] The fit index " << indexFile << " could not be read, it will be rebuilt!" << std::endl;
+    cache.clear();
+  }
+  // Keep the entries of unchanged files and collect the new or modified ones
+  StringVector_t newFiles;
+  for (const auto& fileName : fileNames) {
+    const auto& stamp = fileStamp(resultDir+fileName);
+    const auto& it = cache.find(fileName);
+    if (it!=cache.end() && contain(it->second.Par, "fileStamp") && it->second.Par.at("fileStamp")==stamp) { index[fileName] = it->second; }
+    else { newFiles.push_back(fileName); }
+  }
+  std::cout << "[INFO] Fit index of " << resultDir << ": " << index.size() << " stored and " << newFiles.size() << " new or modified files" << std::endl;
+  // Extract the information of the new or modified files in parallel
+  auto extractFiles = [&](FitIndex_t& content, const size_t& iMin, const size_t& iMax)
+  {
+    for (size_t i = iMin; i < iMax && i < newFiles.size(); i++) {
+      std::cout << "[INFO] Processing file: " << newFiles[i] << std::endl;
+      GlobalInfo info;
+      if (!extractFitInfo(info, resultDir+newFiles[i])) { return false; }
+      info.Par["fileName"] = newFiles[i];
+      info.Par["filePath"] = resultDir+newFiles[i];
+      info.Par["fileStamp"] = fileStamp(resultDir+newFiles[i]);
+      content[newFiles[i]] = info;
+    }
+    return true;
+  };
+  const uint nWorkers = std::max(std::min(nCores, uint(newFiles.size())), 1u);
+  if (nWorkers>1) {
+    // Tag the temporary files with the PID of the parent, so that concurrent jobs on the same directory do not clash
+    const auto& pid = gSystem->GetPid();
+    auto tmpFile = [&](const int& idx) { return (dirPath + Form("fitIndex_%d_%d.root", pid, idx)); };
+    auto extractChunk = [&](int idx)
+    {
+      const size_t size = std::ceil(float(newFiles.size())/float(nWorkers));
+      FitIndex_t content;
+      if (!extractFiles(content, idx*size, (idx+1)*size) || !saveFitIndex(tmpFile(idx), content)) { return 1; }
+      return 0;
+    };
+    ROOT::TProcessExecutor mpe(nWorkers);
+    const auto& res = mpe.Map(extractChunk, ROOT::TSeqI(nWorkers));
+    int nFail = 0;
+    for (const auto& r : res) { nFail += r; }
+    for (uint i = 0; i < nWorkers; i++) {
+      if (nFail==0 && !loadFitIndex(index, tmpFile(i))) { nFail++; }
+      gSystem->Unlink(tmpFile(i).c_str());
+    }
+    if (nFail>0) { std::cout << "[ERROR] Failed to extract the fit information in " << resultDir << std::endl; return false; }
+  }
+  else if (!extractFiles(index, 0, newFiles.size())) { return false; }
+  // Update the stored index
+  if (!newFiles.empty() || index.size()!=cache.size()) {
+    if (!saveFitIndex(indexFile, index)) { return false; }
+    std::cout << "[INFO] Fit index stored in: " << indexFile << std::endl;
+  }
+  if (index.empty()) { std::cout << "[ERROR] getFitIndex: No fit output was found in " << resultDir << std::endl; return false; }
+  return true;
+};
+
+
+template <class B>
+B getFitIndexBin(const GlobalInfo& info, const StringVector_t& obsList)
+{
+  // Define the analysis bin from the range of the observables used in the fit
+  B bin;
+  for (const auto& obs : obsList) {
+    if (obs=="Cand_Rap" && (contain(info.Var, "Cand_RapCM") || contain(info.Var, "Cand_AbsRap"))) continue;
+    if (contain(info.Var, obs)) { bin.setbin(obs, info.Var.at(obs).at("Min"), info.Var.at(obs).at("Max")); }
+  }
+  return bin;
+};
+
+
+template <class B>
+bool getFitIndexBins(std::map< B , GlobalInfo >& content, const std::string& dirPath, const StringVector_t& obsList, const uint& nCores)
+{
+  // Query the index of the fit outputs
+  FitIndex_t index;
+  if (!getFitIndex(index, dirPath, nCores)) { return false; }
+  for (const auto& f : index) { content[getFitIndexBin<B>(f.second, obsList)] = f.second; }
+  return true;
+};
+
+
+#endif // #ifndef fitIndexUtils_h
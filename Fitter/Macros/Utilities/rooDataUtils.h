@@ -7,6 +7,8 @@
 #include "TIterator.h"
 #include "TH1.h"
 #include "TKey.h"
+#include "TTree.h"
+#include "TNamed.h"
 
 #include "RooFit.h"
 #include "RooMsgService.h"
@@ -18,6 +20,8 @@
 #include "RooCategory.h"
 #include "RooAbsPdf.h"
 #include "RooFitResult.h"
+#include "RooFormulaVar.h"
+#include "RooAddPdf.h"
 #include "RooStringVar.h"
 #include "RooList.h"
 
@@ -26,6 +30,8 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <cstring>
 
 #include "initClasses.h"
 #include "../../../Utilities/dataUtils.h"
@@ -451,6 +457,127 @@ bool getDataSet(RooWorkspace& ws, const std::string& dsName, const std::string&
 };
 
 
+// sPlot weights computed from a mass fit, keyed by the identity of each candidate
+//   idVar  : candidate variables used to identify the events
+//   wVar   : sPlot weight variables (N_*_sw)
+//   weight : sPlot weights of each event, indexed by the raw values of idVar
+//   fitStamp : modification time and size of the mass fit file used to compute the weights
+typedef struct SPlotWeight_t {
+  StringVector_t idVar, wVar;
+  std::unordered_map< std::string , std::vector< double > > weight;
+  std::string fitStamp;
+} SPlotWeight_t;
+const StringVector_t SPLOTIDVAR = { "Cand_Mass" , "Cand_Pt" , "Cand_Rap" , "Cand_DLen" , "Cand_DLenErr" , "Dau1_Pt" , "Dau2_Pt" , "Dau1_Eta" , "Dau2_Eta" , "Centrality" , "NTrack" };
+
+
+std::string getEventKey(const RooArgSet& row, const StringVector_t& idVar)
+{
+  std::vector< double > val;
+  for (const auto& v : idVar) { val.push_back(dynamic_cast<RooRealVar*>(row.find(v.c_str()))->getVal()); }
+  return std::string(reinterpret_cast<const char*>(val.data()), val.size()*sizeof(double));
+};
+
+
+bool fillSPlotWeight(SPlotWeight_t& sw, const RooDataSet& ds)
+{
+  sw.idVar.clear(); sw.wVar.clear(); sw.weight.clear();
+  const auto& row = ds.get();
+  for (const auto& v : SPLOTIDVAR) { if (dynamic_cast<RooRealVar*>(row->find(v.c_str()))) { sw.idVar.push_back(v); } }
+  auto varIt = std::unique_ptr<TIterator>(row->createIterator());
+  for (auto itp = varIt->Next(); itp!=NULL; itp = varIt->Next()) {
+    const std::string& name = itp->GetName();
+    if (name.rfind("N_", 0)==0 && name.rfind("_sw")==(name.size()-3)) { sw.wVar.push_back(name); }
+  }
+  if (sw.idVar.empty() || sw.wVar.empty()) { std::cout << "[ERROR] fillSPlotWeight: DataSet " << ds.GetName() << " has no sPlot weights!" << std::endl; return false; }
+  sw.weight.reserve(ds.numEntries());
+  for (int i = 0; i < ds.numEntries(); i++) {
+    const auto& evt = ds.get(i);
+    auto& w = sw.weight[getEventKey(*evt, sw.idVar)];
+    w.clear();
+    for (const auto& v : sw.wVar) { w.push_back(dynamic_cast<RooRealVar*>(evt->find(v.c_str()))->getVal()); }
+  }
+  return true;
+};
+
+
+bool saveSPlotWeight(const SPlotWeight_t& sw, const std::string& fileName)
+{
+  // Write to a temporary file first, so that concurrent jobs never read a partial table
+  const auto& outputDir = fileName.substr(0, fileName.rfind("/")+1);
+  gSystem->mkdir(outputDir.c_str(), kTRUE);
+  const auto& tmpName = fileName + Form(".%d.tmp", gSystem->GetPid());
+  auto file = std::unique_ptr<TFile>(TFile::Open(tmpName.c_str(), "RECREATE"));
+  if (!file || !file->IsOpen() || file->IsZombie()) { std::cout << "[ERROR] Failed to create the sPlot weight file: " << fileName << std::endl; return false; }
+  file->cd();
+  TTree tree("sPlotWeight", "sPlot weights");
+  std::vector< double > idVal(sw.idVar.size()), wVal(sw.wVar.size());
+  for (uint i = 0; i < sw.idVar.size(); i++) { tree.Branch(sw.idVar[i].c_str(), &idVal[i], (sw.idVar[i]+"/D").c_str()); }
+  for (uint i = 0; i < sw.wVar.size(); i++) { tree.Branch(sw.wVar[i].c_str(), &wVal[i], (sw.wVar[i]+"/D").c_str()); }
+  for (const auto& w : sw.weight) {
+    std::memcpy(idVal.data(), w.first.data(), w.first.size());
+    for (uint i = 0; i < wVal.size(); i++) { wVal[i] = w.second[i]; }
+    tree.Fill();
+  }
+  tree.Write();
+  TNamed("fileStamp", sw.fitStamp.c_str()).Write();
+  file->Close();
+  if (gSystem->Rename(tmpName.c_str(), fileName.c_str())!=0) { std::cout << "[ERROR] Failed to store the sPlot weight file: " << fileName << std::endl; return false; }
+  std::cout << "[INFO] sPlot weights of " << sw.weight.size() << " events stored in: " << fileName << std::endl;
+  return true;
+};
+
+
+bool loadSPlotWeight(SPlotWeight_t& sw, const std::string& fileName)
+{
+  sw.idVar.clear(); sw.wVar.clear(); sw.weight.clear(); sw.fitStamp = "";
+  if (!existFile(fileName)) { return false; }
+  auto file = std::unique_ptr<TFile>(TFile::Open(fileName.c_str(), "READ"));
+  if (!file || !file->IsOpen() || file->IsZombie()) { std::cout << "[WARNING] The sPlot weight file " << fileName << " is corrupted!" << std::endl; return false; }
+  auto tree = dynamic_cast<TTree*>(file->Get("sPlotWeight"));
+  if (!tree) { std::cout << "[WARNING] The sPlot weight tree was not found in " << fileName << std::endl; file->Close(); return false; }
+  const auto& stamp = dynamic_cast<TNamed*>(file->Get("fileStamp"));
+  if (stamp) { sw.fitStamp = stamp->GetTitle(); }
+  for (const auto& b : *tree->GetListOfBranches()) {
+    const std::string& name = b->GetName();
+    if (name.rfind("_sw")==(name.size()-3)) { sw.wVar.push_back(name); } else { sw.idVar.push_back(name); }
+  }
+  std::vector< double > idVal(sw.idVar.size()), wVal(sw.wVar.size());
+  for (uint i = 0; i < sw.idVar.size(); i++) { tree->SetBranchAddress(sw.idVar[i].c_str(), &idVal[i]); }
+  for (uint i = 0; i < sw.wVar.size(); i++) { tree->SetBranchAddress(sw.wVar[i].c_str(), &wVal[i]); }
+  sw.weight.reserve(tree->GetEntries());
+  for (Long64_t i = 0; i < tree->GetEntries(); i++) {
+    if (tree->GetEntry(i)<0) { sw.weight.clear(); file->Close(); return false; }
+    sw.weight[std::string(reinterpret_cast<const char*>(idVal.data()), idVal.size()*sizeof(double))] = wVal;
+  }
+  file->Close();
+  std::cout << "[INFO] sPlot weights of " << sw.weight.size() << " events loaded from: " << fileName << std::endl;
+  return (!sw.idVar.empty() && !sw.wVar.empty());
+};
+
+
+bool attachSPlotWeight(std::unique_ptr<RooDataSet>& data, const RooDataSet& ds, const SPlotWeight_t& sw)
+{
+  // Check that the dataset contains the event identity variables
+  for (const auto& v : sw.idVar) {
+    if (!dynamic_cast<RooRealVar*>(ds.get()->find(v.c_str()))) { std::cout << "[WARNING] DataSet " << ds.GetName() << " does not contain the variable " << v << " !" << std::endl; return false; }
+  }
+  // Find the sPlot weights of each event
+  RooArgSet wSet;
+  for (const auto& v : sw.wVar) { wSet.addOwned(*(new RooRealVar(v.c_str(), v.c_str(), -1.0E9, 1.0E9))); }
+  RooDataSet wDS("TMP_SW", "TMP_SW", wSet);
+  for (int i = 0; i < ds.numEntries(); i++) {
+    const auto& w = sw.weight.find(getEventKey(*ds.get(i), sw.idVar));
+    if (w==sw.weight.end()) { std::cout << "[WARNING] Event " << i << " of " << ds.GetName() << " has no sPlot weight!" << std::endl; return false; }
+    for (uint j = 0; j < sw.wVar.size(); j++) { dynamic_cast<RooRealVar*>(wSet.find(sw.wVar[j].c_str()))->setVal(w->second[j]); }
+    wDS.add(wSet);
+  }
+  // Attach the sPlot weights to the dataset
+  data.reset(dynamic_cast<RooDataSet*>(ds.Clone(ds.GetName())));
+  if (!data || data->merge(&wDS)) { std::cout << "[ERROR] Failed to attach the sPlot weights to " << ds.GetName() << std::endl; data.reset(); return false; }
+  return true;
+};
+
+
 bool getPDFData(RooWorkspace& ws, const std::string& pdfName, const std::string& fileName)
 {
   auto dataName = pdfName;
@@ -489,6 +616,117 @@ bool getPDFData(RooWorkspace& ws, const std::string& pdfName, const GlobalInfo&
 };
 
 
+bool saveFitSummary(const RooWorkspace& ws)
+{
+  // Define the summary tree (written in the current directory)
+  TTree tree("fitSummary", "Fit Summary");
+  FitSummaryRow_t row;
+  tree.Branch("kind", &row.kind); tree.Branch("name", &row.name);
+  tree.Branch("title", &row.title); tree.Branch("str", &row.str);
+  tree.Branch("val", &row.val, "val/D"); tree.Branch("err", &row.err, "err/D");
+  tree.Branch("errLo", &row.errLo, "errLo/D"); tree.Branch("errHi", &row.errHi, "errHi/D");
+  tree.Branch("min", &row.min, "min/D"); tree.Branch("max", &row.max, "max/D");
+  tree.Branch("defMin", &row.defMin, "defMin/D"); tree.Branch("defMax", &row.defMax, "defMax/D");
+  tree.Branch("iniVal", &row.iniVal, "iniVal/D"); tree.Branch("iniErr", &row.iniErr, "iniErr/D");
+  tree.Branch("isConst", &row.isConst, "isConst/O");
+  auto addRow = [&](const std::string& kind, const std::string& name) { row = FitSummaryRow_t(); row.kind = kind; row.name = name; };
+  //
+  auto& w = *const_cast<RooWorkspace*>(&ws);
+  const auto& parIni = w.getSnapshot("initialParameters");
+  RooFitResult* fitResult = NULL;
+  for (const auto& ito : w.allGenericObjects()) { const auto& it = dynamic_cast<RooFitResult*>(ito); if (it) { fitResult = it; break; } }
+  // Store the strings
+  std::string dsName = "", pdfName = "";
+  for (const auto& ito : w.allGenericObjects()) {
+    const auto& it = dynamic_cast<RooStringVar*>(ito); if (!it) continue;
+    addRow("STR", it->GetName()); row.title = it->GetTitle(); row.str = it->getVal();
+    if (row.name=="dsName") { dsName = row.str; }
+    if (row.name=="pdfName") { pdfName = row.str; }
+    tree.Fill();
+  }
+  if (dsName=="" && w.obj("dsNameFit")) { dsName = w.obj("dsNameFit")->GetTitle(); }
+  // Store the variables
+  auto vars = w.allVars();
+  auto varIt = std::unique_ptr<TIterator>(vars.createIterator());
+  for (auto itp = varIt->Next(); itp!=NULL; itp = varIt->Next()) {
+    const auto& it = dynamic_cast<RooRealVar*>(itp); if (!it) continue;
+    addRow("VAR", it->GetName());
+    row.val = it->getVal(); row.err = it->getError(); row.errLo = it->getErrorLo(); row.errHi = it->getErrorHi();
+    row.min = it->getMin(); row.max = it->getMax(); row.defMin = it->getMin(it->hasRange("DEFAULT") ? "DEFAULT" : 0); row.defMax = it->getMax(it->hasRange("DEFAULT") ? "DEFAULT" : 0);
+    row.isConst = ((it->getMin()==it->getMax()) || it->isConstant());
+    const auto& itIni = (parIni ? dynamic_cast<RooRealVar*>(parIni->find(it->GetName())) : NULL);
+    if (itIni) { row.iniVal = itIni->getVal(); row.iniErr = itIni->getError(); }
+    tree.Fill();
+  }
+  // Store the formulas
+  auto funcIt = std::unique_ptr<TIterator>(ws.componentIterator());
+  for (auto itp = funcIt->Next(); itp!=NULL; itp = funcIt->Next()) {
+    const auto& it = dynamic_cast<RooFormulaVar*>(itp); if (!it) continue;
+    addRow("FUNC", it->GetName());
+    row.val = it->getVal();
+    if (fitResult) { row.err = it->getPropagatedError(*fitResult); }
+    if (parIni) { row.iniVal = it->getValV(parIni); }
+    tree.Fill();
+  }
+  // Store the observables and categories of the dataset
+  if (w.set(("SET_"+dsName).c_str())) {
+    auto obsIt = std::unique_ptr<TIterator>(w.set(("SET_"+dsName).c_str())->createIterator());
+    for (auto it = obsIt->Next(); it!=NULL; it = obsIt->Next()) {
+      if (dynamic_cast<RooRealVar*>(it)) { addRow("OBS", it->GetName()); tree.Fill(); }
+      else if (dynamic_cast<RooCategory*>(it)) { addRow("CAT", it->GetName()); tree.Fill(); }
+    }
+  }
+  // Store the dataset statistics
+  auto ds = dynamic_cast<RooDataSet*>(w.data(("CutAndCount_"+dsName).c_str()));
+  if (!ds) { ds = dynamic_cast<RooDataSet*>(w.data(dsName.c_str())); }
+  if (ds) {
+    addRow("DS", ds->GetName()); row.val = ds->sumEntries(); tree.Fill();
+    if (w.var("Cand_Rap") && ds->get()->find("Cand_Rap")) {
+      auto rapDS = std::unique_ptr<RooDataSet>(dynamic_cast<RooDataSet*>(ds->reduce(RooArgSet(*w.var("Cand_Rap")))));
+      for (const auto& v : StringMap_t({{"Cand_AbsRap", "abs(Cand_Rap)"}, {"Cand_RapCM", "Cand_Rap-0.465"}})) {
+	if (!w.var(v.first.c_str())) continue;
+	RooFormulaVar rapVar(v.first.c_str(), v.second.c_str(), RooArgList(*w.var("Cand_Rap")));
+	rapDS->addColumn(rapVar);
+	const auto& var = dynamic_cast<RooRealVar*>(rapDS->get()->find(v.first.c_str())); if (!var) continue;
+	auto mean = std::unique_ptr<RooRealVar>(rapDS->meanVar(*var));
+	auto rms = std::unique_ptr<RooRealVar>(rapDS->rmsVar(*var));
+	addRow("DSVAR", v.first); row.val = mean->getVal(); row.err = rms->getVal(); tree.Fill();
+      }
+    }
+  }
+  // Store the PDF information
+  const auto& pdf = w.pdf(pdfName.c_str());
+  if (pdf) {
+    addRow("PDF", pdfName);
+    const auto& addPdf = dynamic_cast<RooAddPdf*>(pdf);
+    if (addPdf) { row.val = addPdf->expectedEvents(addPdf->coefList()); }
+    if (w.var("Cand_Mass")) { auto pars = std::unique_ptr<RooArgSet>(pdf->getParameters(*w.var("Cand_Mass"))); if (pars) { row.iniVal = pars->getSize(); } }
+    tree.Fill();
+  }
+  // Store the fit status
+  if (fitResult) {
+    for (const auto& f : std::vector<std::pair<std::string, double>>({{"status", double(fitResult->status())}, {"covQual", double(fitResult->covQual())}, {"minNll", fitResult->minNll()}, {"edm", fitResult->edm()}})) {
+      addRow("FIT", f.first); row.val = f.second; tree.Fill();
+    }
+  }
+  // Store the snapshots
+  if (w.set("snapshots")) {
+    auto snapIt = std::unique_ptr<TIterator>(w.set("snapshots")->createIterator());
+    for (auto its = snapIt->Next(); its!=NULL; its = snapIt->Next()) {
+      const auto& snap = ws.getSnapshot(its->GetName()); if (!snap) continue;
+      auto parIt = std::unique_ptr<TIterator>(snap->createIterator());
+      for (auto itp = parIt->Next(); itp!=NULL; itp = parIt->Next()) {
+	const auto& it = dynamic_cast<RooRealVar*>(itp); if (!it) continue;
+	addRow("SNAP", it->GetName()); row.title = its->GetName();
+	row.val = it->getVal(); row.err = it->getError(); row.min = it->getMin(); row.max = it->getMax();
+	tree.Fill();
+      }
+    }
+  }
+  return (tree.Write()>0);
+};
+
+
 bool saveWorkSpace(const RooWorkspace& ws, const std::string& outputDir, const std::string& fileName, const bool& saveDS=true)
 {
   // Create the output file
@@ -521,6 +759,9 @@ bool saveWorkSpace(const RooWorkspace& ws, const std::string& outputDir, const s
     const auto& it = dynamic_cast<RooDataHist*>(itp);
     if (it) { it->Write(it->GetName()); }
   }
+  // Save the fit summary
+  file->cd();
+  if (!saveFitSummary(ws)) { std::cout << "[WARNING] Fit summary could not be saved in: " << (outputDir+fileName) << std::endl; }
   // Write and close output file
   file->Write(); file->Close();
   std::cout << "[INFO] RooWorkspace saved in: " << (outputDir+fileName) << std::endl;
@@ -716,21 +957,33 @@ bool loadFitResult(RooWorkspace& ws, const std::string& fileName, const std::str
     std::cout << "[INFO] Parameters from " << fileName << " has already been loaded!" << std::endl;
     return true;
   }
-  // Extract the workspace
+  // Extract the workspace, or only the fit summary if the PDF is already loaded
   RooWorkspace inWS;
+  FitSummary_t summary;
+  std::map< std::string , std::pair< double , double > > snapPar;
   if (!ws.pdf(pdfName.c_str())) {
     if (!getWorkSpace(inWS, fileName, "")) { return false; }
     const auto& pdf = inWS.pdf(pdfName.c_str());
     if (!pdf) { std::cout << "[ERROR] PDF " << pdfName << " was not found in " << fileName << std::endl; return false; }
     if (ws.import(*pdf, RooFit::RecycleConflictNodes())) { std::cout << "[ERROR] PDF " << pdfName << " was not imported!" << std::endl; return false; }
   }
+  else if (getFitSummary(summary, fileName)) {
+    for (const auto& r : summary) { if (r.kind=="SNAP" && r.title==snapName) { snapPar[r.name] = std::make_pair(r.val, r.err); } }
+  }
   else if (!getWorkSpace(inWS, fileName, "", true)) { return false; }
   // Extract PDF
   const auto& pdf = ws.pdf(pdfName.c_str());
   if (!pdf) { std::cout << "[INFO] PDF " << pdfName << " was not found!" << std::endl; return false; }
   // Extract the snapshot
-  const RooArgSet* snapPar = (inWS.set(snapName.c_str()) ? inWS.getSnapshot(snapName.c_str()) : NULL);
-  if (!snapPar) { std::cout << "[INFO] Snapshot " << snapName << " was not found!" << std::endl; return false; }
+  if (snapPar.empty()) {
+    const RooArgSet* snap = (inWS.set(snapName.c_str()) ? inWS.getSnapshot(snapName.c_str()) : NULL);
+    if (!snap) { std::cout << "[INFO] Snapshot " << snapName << " was not found!" << std::endl; return false; }
+    auto snapIt = std::unique_ptr<TIterator>(snap->createIterator());
+    for (auto itp = snapIt->Next(); itp!=NULL; itp = snapIt->Next()) {
+      const auto& it = dynamic_cast<RooRealVar*>(itp);
+      if (it) { snapPar[it->GetName()] = std::make_pair(it->getVal(), it->getError()); }
+    }
+  }
   // Loop over PDF variables and load from snapshot
   std::string res = ""; RooArgSet loadSet;
   auto params = std::unique_ptr<RooArgSet>(pdf->getVariables());
@@ -739,22 +992,21 @@ bool loadFitResult(RooWorkspace& ws, const std::string& fileName, const std::str
     const std::string& name = it->GetName();
     if (!ws.var(name.c_str())) continue;
     if (!loadYield && (name.rfind("N_",0)==0 || name.rfind("R_",0)==0)) continue;
-    const auto& sPar = dynamic_cast<RooRealVar*>(snapPar->find(name.c_str()));
     double val = -99999.;
     double unc = -99999.;
-    if (name.rfind("N_",0)==0 && !sPar && snapPar->find(("R_"+name.substr(2)).c_str())) {
+    if (name.rfind("N_",0)==0 && !contain(snapPar, name) && contain(snapPar, "R_"+name.substr(2))) {
       const auto& vN = name.substr(2);
       const auto& obj = vN.substr(0, vN.find("To"));
       auto rN = vN; stringReplace(rN, obj, (obj=="Psi2S"?"JPsi":(obj=="Ups2S"?"Ups1S":(obj=="Ups3S"?"Ups1S":obj))));
-      const auto& rPar = dynamic_cast<RooRealVar*>(snapPar->find(("R_"+vN).c_str()));
-      const auto& nPar = dynamic_cast<RooRealVar*>(snapPar->find(("N_"+rN).c_str()));
-      if (!nPar) { std::cout << "[ERROR] Parameter " << ("N_"+rN) << " was not found in snapshot " << snapName << std::endl; return false; }
-      val = rPar->getVal()*nPar->getVal();
-      unc = std::sqrt(std::pow(rPar->getVal()*nPar->getError(), 2.0) + std::pow(rPar->getError()*nPar->getVal(), 2.0));
+      if (!contain(snapPar, "N_"+rN)) { std::cout << "[ERROR] Parameter " << ("N_"+rN) << " was not found in snapshot " << snapName << std::endl; return false; }
+      const auto& rPar = snapPar.at("R_"+vN);
+      const auto& nPar = snapPar.at("N_"+rN);
+      val = rPar.first*nPar.first;
+      unc = std::sqrt(std::pow(rPar.first*nPar.second, 2.0) + std::pow(rPar.second*nPar.first, 2.0));
     }
-    else if (sPar) {
-      val = sPar->getVal(); if (name.rfind("N_",0)==0) { val = std::max(val, 0.0); }
-      unc = sPar->getError();
+    else if (contain(snapPar, name)) {
+      val = snapPar.at(name).first; if (name.rfind("N_",0)==0) { val = std::max(val, 0.0); }
+      unc = snapPar.at(name).second;
     }
     if (val!=-99999.) {
       ws.var(name.c_str())->setVal(val);
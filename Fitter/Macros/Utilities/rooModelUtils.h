@@ -2,6 +2,10 @@
 #define rooModelUtils_h
 
 #include "TH1.h"
+#include "TFile.h"
+#include "TNamed.h"
+#include "TString.h"
+#include "TSystem.h"
 #include "TInterpreter.h"
 
 #include "RooFit.h"
@@ -9,6 +13,7 @@
 #include "RooDataHist.h"
 #include "RooRealVar.h"
 #include "RooHistPdf.h"
+#include "RooKeysPdf.h"
 
 #include <iostream>
 #include <string>
@@ -373,4 +378,110 @@ bool histToPdf(RooWorkspace& ws, const std::string& pdfName, const std::string&
 };
 
 
+std::string getTemplateKey(const RooWorkspace& ws, const RooDataSet& ds, const std::string& dsName, const std::string& var, const std::vector< double >& range, const std::string& type)
+{
+  // The key identifies the template by source dataset, selection, variable and range
+  // The dataset content is fingerprinted to detect changes in the input
+  const auto& v = dynamic_cast<RooRealVar*>(ds.get()->find(var.c_str()));
+  const double mean = (v ? ds.mean(*v) : 0.0), sigma = (v ? ds.sigma(*v) : 0.0);
+  std::string key = type + "|" + dsName + "|" + getString(ws, "cutDSFit") + "|" + var;
+  for (const auto& r : range) { key += Form("|%.10g", r); }
+  key += Form("|%d|%.10g|%.10g|%.10g", ds.numEntries(), ds.sumEntries(), mean, sigma);
+  return key;
+};
+
+
+std::string getTemplateFile(const std::string& cacheDir, const std::string& key)
+{
+  return (cacheDir + "TEMPLATE_" + TString(key.c_str()).MD5().Data() + ".root");
+};
+
+
+bool loadTemplate(RooWorkspace& ws, const std::string& pdfName, const std::string& key, const std::string& cacheDir, const std::string& var, const std::string& type)
+{
+  const auto& fileName = getTemplateFile(cacheDir, key);
+  if (!existFile(fileName)) { return false; }
+  auto file = std::unique_ptr<TFile>(TFile::Open(fileName.c_str(), "READ"));
+  if (!file || !file->IsOpen() || file->IsZombie()) { std::cout << "[WARNING] Template cache file " << fileName << " is corrupted!" << std::endl; return false; }
+  file->cd();
+  // Check that the stored template matches the key
+  const auto& keyN = dynamic_cast<TNamed*>(file->Get("templateKey"));
+  if (!keyN || key!=keyN->GetTitle()) { std::cout << "[WARNING] Template cache file " << fileName << " does not match " << pdfName << std::endl; file->Close(); return false; }
+  const auto& inData = dynamic_cast<RooDataHist*>(file->Get("templateData"));
+  const auto& inPdf = dynamic_cast<RooAbsPdf*>(file->Get("templatePdf"));
+  if ((type!="DSKEYS" && !inData) || (type!="HIST" && !inPdf)) { std::cout << "[WARNING] Template cache file " << fileName << " is incomplete!" << std::endl; file->Close(); return false; }
+  const double varMin = ws.var(var.c_str())->getMin(), varMax = ws.var(var.c_str())->getMax(), varNBins = ws.var(var.c_str())->getBins(); // Bug Fix
+  // Import the binned template
+  if (inData) {
+    auto dataName = pdfName;
+    dataName.replace(dataName.find("pdf"), std::string("pdf").length(), "dh");
+    if (!ws.data(dataName.c_str())) {
+      auto dataHist = std::unique_ptr<RooDataHist>(new RooDataHist(*inData, dataName.c_str()));
+      if (ws.import(*dataHist)) { std::cout << "[ERROR] RooDataHist " << dataName << " was not imported from the template cache!" << std::endl; file->Close(); return false; }
+    }
+  }
+  // Import the kernel estimated PDF, or build the histogram PDF from the binned template
+  if (type=="HIST") {
+    auto dataName = pdfName;
+    dataName.replace(dataName.find("pdf"), std::string("pdf").length(), "dh");
+    if (!dataHistToPdf(ws, pdfName, dataName, var, type)) { file->Close(); return false; }
+  }
+  else {
+    auto pdf = std::unique_ptr<RooAbsPdf>(dynamic_cast<RooAbsPdf*>(inPdf->clone(pdfName.c_str())));
+    if (!pdf || ws.import(*pdf, RooFit::RecycleConflictNodes())) { std::cout << "[ERROR] PDF " << pdfName << " was not imported from the template cache!" << std::endl; file->Close(); return false; }
+  }
+  ws.var(var.c_str())->setRange(varMin, varMax); ws.var(var.c_str())->setBins(varNBins); // Bug Fix
+  file->Close();
+  std::cout << "[INFO] Template " << pdfName << " loaded from cache: " << fileName << std::endl;
+  return true;
+};
+
+
+bool saveTemplate(const RooWorkspace& ws, const std::string& pdfName, const std::string& key, const std::string& cacheDir, const std::string& type)
+{
+  const auto& pdf = ws.pdf(pdfName.c_str());
+  if (!pdf) { std::cout << "[ERROR] PDF " << pdfName << " was not found!" << std::endl; return false; }
+  auto dataName = pdfName;
+  dataName.replace(dataName.find("pdf"), std::string("pdf").length(), "dh");
+  const auto& dataHist = dynamic_cast<RooDataHist*>(ws.data(dataName.c_str()));
+  if (type!="DSKEYS" && !dataHist) { std::cout << "[ERROR] RooDataHist " << dataName << " was not found!" << std::endl; return false; }
+  makeDir(cacheDir);
+  // Write to a temporary file first, so that concurrent jobs never read a partial template
+  const auto& fileName = getTemplateFile(cacheDir, key);
+  const auto& tmpName = fileName + Form(".%d.tmp", gSystem->GetPid());
+  auto file = std::unique_ptr<TFile>(TFile::Open(tmpName.c_str(), "RECREATE"));
+  if (!file || !file->IsOpen() || file->IsZombie()) { std::cout << "[ERROR] Failed to create the template cache file: " << fileName << std::endl; return false; }
+  file->cd();
+  TNamed("templateKey", key.c_str()).Write();
+  if (dataHist) { dataHist->Write("templateData"); }
+  if (type!="HIST") { pdf->Write("templatePdf"); }
+  file->Close();
+  if (gSystem->Rename(tmpName.c_str(), fileName.c_str())!=0) { std::cout << "[ERROR] Failed to store the template cache file: " << fileName << std::endl; return false; }
+  return true;
+};
+
+
+bool cachedTemplateToPdf(RooWorkspace& ws, const std::string& pdfName, const RooDataSet& ds, const std::string& dsName, const std::string& var,
+			 const std::vector< double >& range, const std::string& type, const GlobalInfo& info)
+{
+  // Reuse the template if it was already built for the same input, in this or a previous job
+  if (ws.pdf(pdfName.c_str())) { std::cout << "[INFO] The " << pdfName << " Template has already been created!" << std::endl; return true; }
+  if (!ws.var(var.c_str())) { std::cout << "[ERROR] Variable " << var << " was not found!" << std::endl; return false; }
+  const auto& cacheDir = info.Par.at("outputDir") + "templates/";
+  const auto& key = getTemplateKey(ws, ds, dsName, var, range, type);
+  if (loadTemplate(ws, pdfName, key, cacheDir, var, type)) { return true; }
+  // Build the template
+  if (type=="DSKEYS") {
+    if (!ws.factory(Form("RooKeysPdf::%s(%s, %s, %s)", pdfName.c_str(), var.c_str(),
+			 dsName.c_str(),
+			 "MirrorAsymBoth"
+			 ))) { std::cout << "[ERROR] Failed to create PDF " << pdfName << std::endl; return false; }
+  }
+  else if (!histToPdf(ws, pdfName, ds, var, range, type)) { return false; }
+  // Store it in the cache
+  if (!saveTemplate(ws, pdfName, key, cacheDir, type)) { std::cout << "[WARNING] Template " << pdfName << " was not cached!" << std::endl; }
+  return true;
+};
+
+
 #endif // #ifndef rooModelUtils_h
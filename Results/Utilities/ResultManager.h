@@ -6,6 +6,12 @@
 #include "extractResultsTree.C"
 #include "processResultsTree.C"
 #include "plotResultsTree.C"
+// ROOT headers
+#include "ROOT/TProcessExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+// c++ headers
+#include <tuple>
+#include <cmath>
 
 
 class ResultManager
@@ -16,6 +22,7 @@ class ResultManager
 
   // setters
   void doSyst(const bool& s) { doSyst_ = s; };
+  void setNCores(const uint& n) { nCores_ = n; };
   void setWorkDirInfo(const WSDirMap_t& w) { workDirInfo_ = w; };
   void setWorkDirInfo(const std::string& w) { workDirInfo_.at("Nominal").at("Nominal").first[0] = w; }
   void setFitDir(const std::string& mD, const StringVector_t& sD={""}, const StringVector_t& dL={""});
@@ -30,6 +37,7 @@ class ResultManager
  private:
   // attributes
   bool doSyst_, isDLCut_;
+  uint nCores_;
   WSDirMap_t workDirInfo_;
   std::string sample_, fitVariable_, mainDirectory_, preCWD_, CWD_, effDirectory_;
   StringVector_t triggers_, objects_, collisionSystems_, decayLengthDirectories_, subDirectories_;
@@ -42,8 +50,9 @@ class ResultManager
   GraphSeptaMap_t graphMap_;
 
   // functions
-  bool extract(VarBinQuadMap_t& inputVar, const std::string& wkDir);
+  bool extract(VarBinQuadMap_t& inputVar, const std::string& wkDir, const uint& nCores);
   bool process(BinSextaMap_t& var, BinSeptaMapVec_t& systVar, VarBinQuadMap_t& inputVar, const bool& isNominal, const std::string& fitLabel, const IntMap_t& systCorr);
+  bool processWorkDir(BinSextaMap_t& var, BinSeptaMapVec_t& systVar, VarBinQuadMap_t& inputVar, const bool& isNominal, const std::string& wkDir, const IntMap_t& systCorr, const uint& nCores);
   const std::string nDir(const std::string& s) const { return ((s!="" && strcmp(&s.back(),"/")) ? (s + "/") : s); }
 };
 
@@ -52,6 +61,7 @@ ResultManager::ResultManager()
 {
   doSyst_ = false;
   isDLCut_ = false;
+  nCores_ = 1;
   workDirInfo_ = WSDirMap_t({{"Nominal", {{"Nominal", {{""}, {{"Rap", 1}, {"Obj", 1}}}}}}});
   CWD_ = getcwd(NULL, 0);
   preCWD_ = CWD_;
@@ -85,7 +95,7 @@ void ResultManager::setEffDir(const std::string& mD)
 };
 
 
-bool ResultManager::extract(VarBinQuadMap_t& inputVar, const std::string& wkDir)
+bool ResultManager::extract(VarBinQuadMap_t& inputVar, const std::string& wkDir, const uint& nCores)
 {
   for (const auto& dLDir : decayLengthDirectories_) {
     for (const auto& sDir : subDirectories_) {
@@ -96,7 +106,7 @@ bool ResultManager::extract(VarBinQuadMap_t& inputVar, const std::string& wkDir)
 	for (const auto& colTag : collisionSystems_) {
 	  for (const auto& objTag : objects_) {
 	    const auto& dL = (dLDir!="" ? dLDir : "Inclusive");
-	    if (!extractResultsTree(inputVar[dL], wsN, trgTag, colTag, objTag, sample_, fitVariable_)) { return false; }
+	    if (!extractResultsTree(inputVar[dL], wsN, trgTag, colTag, objTag, sample_, fitVariable_, true, nCores)) { return false; }
 	  }
 	}
       }
@@ -123,6 +133,17 @@ bool ResultManager::process(BinSextaMap_t& var, BinSeptaMapVec_t& systVar, VarBi
 };
 
 
+bool ResultManager::processWorkDir(BinSextaMap_t& var, BinSeptaMapVec_t& systVar, VarBinQuadMap_t& inputVar, const bool& isNominal, const std::string& wkDir, const IntMap_t& systCorr, const uint& nCores)
+{
+  std::cout << "[INFO] Adding results for : " << nDir(mainDirectory_) + wkDir << std::endl;
+  // extract the information
+  if (!extract(inputVar, wkDir, nCores)) { return false; }
+  // process the information
+  if (!process(var, systVar, inputVar, isNominal, wkDir, systCorr)) { return false; }
+  return true;
+};
+
+
 bool ResultManager::extractAndProcess()
 {
   // set nominal directory first and then the others
@@ -132,30 +153,70 @@ bool ResultManager::extractAndProcess()
       workDirs.push_back(t1.first);
     }
   }
-  // loop over fit directories
+  // loop over fit directories, processing the nominal ones first since the variations depend on them
+  std::vector< std::tuple< std::string , std::string , std::string > > varDirs;
   for (const auto& t1 : workDirs) {
     const bool isNominal = (t1=="Nominal");
     if (!doSyst_ && !isNominal) continue;
     for (const auto& t2 : workDirInfo_.at(t1)) {
       for (const auto& wkDir : t2.second.first) {
-	std::cout << "[INFO] Adding results for : " << nDir(mainDirectory_) + wkDir << std::endl;
-	// extract the information
+	if (!isNominal) { varDirs.push_back(std::make_tuple(t1, t2.first, wkDir)); continue; }
 	VarBinQuadMap_t inputVar;
-	if (!extract(inputVar, wkDir)) { return false; }
-	// process the information
 	BinSextaMap_t var;
 	BinSeptaMapVec_t systVar;
-	if (!process(var, systVar, inputVar, isNominal, wkDir, t2.second.second)) { return false; }
-	if (isNominal) {
-	  var_["Nominal"] = var;
-	  systVar_["Efficiency"] = systVar;
-	  inputVarNom_ = inputVar;
-        }
-	else {
-	  systVar_[t1][t2.first].push_back(var);
-	}
+	if (!processWorkDir(var, systVar, inputVar, isNominal, wkDir, t2.second.second, nCores_)) { return false; }
+	var_["Nominal"] = var;
+	systVar_["Efficiency"] = systVar;
+	inputVarNom_ = inputVar;
+      }
+    }
+  }
+  // process the variations, which are independent of each other
+  std::vector< BinSextaMap_t > varVec(varDirs.size());
+  const uint nWorkers = std::max(std::min(nCores_, uint(varDirs.size())), 1u);
+  if (nWorkers>1) {
+    // split the cores among the forked workers, so that the harvest of each one does not fork again
+    const uint nSubCores = std::max(nCores_/nWorkers, 1u);
+    const std::string& tmpDir = CWD_ + "/Output/Results/" + mainDirectory_ + "/tmp";
+    gSystem->mkdir(tmpDir.c_str(), kTRUE);
+    // tag the temporary files with the PID of the parent, so that concurrent jobs on the same directory do not clash
+    const auto& pid = gSystem->GetPid();
+    auto tmpFile = [&](const size_t& i) { return (tmpDir + Form("/variation_%d_%lu.root", pid, i)); };
+    auto processVariations = [&](int idx)
+    {
+      const size_t size = std::ceil(float(varDirs.size())/float(nWorkers));
+      int nFail = 0;
+      for (size_t i = idx*size; i < (idx+1)*size; i++) {
+	if (i>=varDirs.size()) break;
+	const auto& systCorr = workDirInfo_.at(std::get<0>(varDirs[i])).at(std::get<1>(varDirs[i])).second;
+	VarBinQuadMap_t inputVar;
+	BinSeptaMapVec_t systVar;
+	if (!processWorkDir(varVec[i], systVar, inputVar, false, std::get<2>(varDirs[i]), systCorr, nSubCores) ||
+	    !saveResultMap(tmpFile(i), varVec[i])) { nFail++; }
       }
+      return nFail;
+    };
+    ROOT::TProcessExecutor mpe(nWorkers);
+    const auto& res = mpe.Map(processVariations, ROOT::TSeqI(nWorkers));
+    int nFail = 0;
+    for (const auto& r : res) { nFail += r; }
+    // merge the variations in the order of the fit directories
+    for (size_t i = 0; i < varDirs.size(); i++) {
+      if (nFail==0 && !loadResultMap(varVec[i], tmpFile(i))) { nFail++; }
+      gSystem->Unlink(tmpFile(i).c_str());
     }
+    if (nFail>0) { std::cout << "[ERROR] Failed to process " << nFail << " systematic variations!" << std::endl; return false; }
+  }
+  else {
+    for (size_t i = 0; i < varDirs.size(); i++) {
+      const auto& systCorr = workDirInfo_.at(std::get<0>(varDirs[i])).at(std::get<1>(varDirs[i])).second;
+      VarBinQuadMap_t inputVar;
+      BinSeptaMapVec_t systVar;
+      if (!processWorkDir(varVec[i], systVar, inputVar, false, std::get<2>(varDirs[i]), systCorr, nCores_)) { return false; }
+    }
+  }
+  for (size_t i = 0; i < varDirs.size(); i++) {
+    systVar_[std::get<0>(varDirs[i])][std::get<1>(varDirs[i])].push_back(varVec[i]);
   }
   // compute systematics
   if (doSyst_) { computeSystematic(var_, systVar_); }
@@ -206,7 +267,7 @@ void ResultManager::plot()
   const std::string& outDir = CWD_ + "/Output/Results/" + mainDirectory_+"/" + fitVariable_+"/" + sample_+"_"+tTag+"/" + oTag+"/" + cTag;
   const bool isMC = (sample_!="DATA");
   // plot results
-  plotResultsTree(graphMap_, binMap_, var_.at("Nominal"), outDir, isMC, doSyst_);
+  plotResultsTree(graphMap_, binMap_, var_.at("Nominal"), outDir, isMC, doSyst_, nCores_);
 };
 
 
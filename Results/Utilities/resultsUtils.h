@@ -14,11 +14,17 @@
 #include "TPaletteAxis.h"
 #include "TF1.h"
 #include "TMatrixD.h"
+#include "TROOT.h"
+#include "ROOT/TProcessExecutor.hxx"
+#include "ROOT/TSeq.hxx"
 // RooFit headers
 // c++ headers
 #include <iostream>
 #include <string>
 #include <map>
+#include <tuple>
+#include <functional>
+#include <cmath>
 // CMS headers
 
 
@@ -58,6 +64,17 @@ typedef std::map< std::string    , GraphSextaMap_t   > GraphSeptaMap_t;
 typedef std::pair< StringVector_t, IntMap_t          > StringVecIntPair_t;
 typedef std::map< std::string    , StringVecIntPair_t > StringVecIntPairMap_t;
 typedef std::map< std::string , StringVecIntPairMap_t > WSDirMap_t;
+typedef std::tuple< std::string , std::string , std::string , std::string , AnaBin_t > ResultKey_t;
+// Flat result table, only used by computeSystematic for now: the cross-section, ratio and plotting stages still use the nested maps
+typedef struct ResultTable_t {
+  std::map< ResultKey_t , size_t >  idx;    // interned (object, collision, PD, variable, bin) key -> row
+  std::vector< ResultKey_t >        key;    // row -> key
+  std::map< std::string , size_t >  colIdx; // interned column name -> column
+  StringVector_t                    col;    // column -> name
+  size_t                            nVar=0; // number of variants
+  DoubleVec_t                       val;    // [(variant*nCol + column)*nRow + row]
+  std::vector< char >               has;
+} ResultTable_t;
 
 // TO REMOVE
 typedef std::pair< AnaBin_t        , AnaBin_t            > BinPair2_t;
@@ -78,6 +95,7 @@ typedef std::map< std::string    , GraphPentaMap2_t   > GraphSextaMap2_t;
 const std::vector<int> COLOR({kBlack, kRed, kGreen+2, kBlue+2, kAzure-7, kYellow-3, kMagenta+3, kCyan+3, kOrange+9, kSpring+4, kTeal+4, kViolet+9, kPink+8});
 const StringVector_t   STAT({ "Err_Stat_High" , "Err_Stat_Low" });
 const StringVector_t   SYST({ "Err_Syst_High" , "Err_Syst_Low" });
+const StringVector_t   PLOTFORMAT({ "png" , "pdf" , "root" });
 
 
 // ------------------ FUNCTION -------------------------------
@@ -132,6 +150,114 @@ double sumErrors(const DoubleVec_t& errV, const TMatrixD& corrM=TMatrixD())
 };
 
 
+size_t addResultRow(ResultTable_t& tab, const ResultKey_t& key)
+{
+  const auto& it = tab.idx.find(key);
+  if (it!=tab.idx.end()) { return it->second; }
+  tab.idx[key] = tab.key.size();
+  tab.key.push_back(key);
+  return (tab.key.size()-1);
+};
+
+
+int getResultColumn(const ResultTable_t& tab, const std::string& col)
+{
+  const auto& it = tab.colIdx.find(col);
+  return ((it!=tab.colIdx.end()) ? int(it->second) : -1);
+};
+
+
+void initResultTable(ResultTable_t& tab, const size_t& nVar, const StringVector_t& col)
+{
+  tab = ResultTable_t();
+  tab.nVar = nVar;
+  tab.col = col;
+  for (size_t i=0; i<col.size(); i++) { tab.colIdx[col[i]] = i; }
+};
+
+
+void allocResultTable(ResultTable_t& tab)
+{
+  // Must be called once all rows have been interned
+  tab.val.assign(tab.nVar*tab.col.size()*tab.key.size(), 0.0);
+  tab.has.assign(tab.val.size(), 0);
+};
+
+
+size_t getResultIndex(const ResultTable_t& tab, const size_t& iVar, const size_t& iCol, const size_t& iRow)
+{
+  if (iVar>=tab.nVar || iCol>=tab.col.size() || iRow>=tab.key.size()) {
+    throw std::out_of_range(Form("[ERROR] getResultIndex: Invalid variant %lu , column %lu , row %lu", iVar, iCol, iRow));
+  }
+  return ((iVar*tab.col.size() + iCol)*tab.key.size() + iRow);
+};
+
+
+bool hasResultValue(const ResultTable_t& tab, const size_t& iVar, const size_t& iCol, const size_t& iRow)
+{
+  return tab.has[getResultIndex(tab, iVar, iCol, iRow)];
+};
+
+
+double getResultValue(const ResultTable_t& tab, const size_t& iVar, const size_t& iCol, const size_t& iRow)
+{
+  const auto& i = getResultIndex(tab, iVar, iCol, iRow);
+  if (!tab.has[i]) {
+    throw std::out_of_range(Form("[ERROR] getResultValue: No entry for variant %lu , column %lu , row %lu", iVar, iCol, iRow));
+  }
+  return tab.val[i];
+};
+
+
+void setResultValue(ResultTable_t& tab, const size_t& iVar, const size_t& iCol, const size_t& iRow, const double& val)
+{
+  const auto& i = getResultIndex(tab, iVar, iCol, iRow);
+  tab.val[i] = val;
+  tab.has[i] = 1;
+};
+
+
+void fillResultTable(ResultTable_t& tab, const BinSextaMapVec_t& varVec, const StringVector_t& col)
+{
+  initResultTable(tab, varVec.size(), col);
+  // Intern the keys of all variants in a single walk, so they share the same row index
+  std::vector< std::tuple< size_t , size_t , size_t , double > > entries;
+  for (size_t iVar=0; iVar<varVec.size(); iVar++) {
+    for (const auto& o : varVec[iVar]) {
+      for (const auto& c : o.second) {
+	for (const auto& pd : c.second) {
+	  for (const auto& v : pd.second) {
+	    for (const auto& t : v.second) {
+	      const auto& iCol = getResultColumn(tab, t.first);
+	      if (iCol<0) continue;
+	      for (const auto& b : t.second) {
+		const auto& iRow = addResultRow(tab, ResultKey_t(o.first, c.first, pd.first, v.first, b.first));
+		entries.push_back(std::make_tuple(iVar, size_t(iCol), iRow, b.second));
+	      }
+	    }
+	  }
+	}
+      }
+    }
+  }
+  // Fill the contiguous value array
+  allocResultTable(tab);
+  for (const auto& e : entries) { setResultValue(tab, std::get<0>(e), std::get<1>(e), std::get<2>(e), std::get<3>(e)); }
+};
+
+
+void fillResultMap(BinSextaMap_t& var, const ResultTable_t& tab, const size_t& iVar)
+{
+  for (size_t iRow=0; iRow<tab.key.size(); iRow++) {
+    const auto& k = tab.key[iRow];
+    auto& valMap = var[std::get<0>(k)][std::get<1>(k)][std::get<2>(k)][std::get<3>(k)];
+    for (size_t iCol=0; iCol<tab.col.size(); iCol++) {
+      if (hasResultValue(tab, iVar, iCol, iRow)) { valMap[tab.col[iCol]][std::get<4>(k)] = getResultValue(tab, iVar, iCol, iRow); }
+    }
+  }
+};
+
+
 double divide(const DoubleVec_t& numV, const DoubleVec_t& denV)
 {
   // check inputs
@@ -512,7 +638,42 @@ std::tuple<double, double, double> computeStats(TGraphAsymmErrors& gr)
 };
 
 
-void drawParametersGraph(GraphSextaMap2_t& graphMap, const std::string& outDir, const bool& isMC)
+void saveCanvas(TCanvas& c, const std::string& plotDir, const std::string& name, const StringVector_t& formats)
+{
+  for (const auto& f : formats) {
+    makeDir(plotDir + "/" + f + "/");
+    c.SaveAs((plotDir + "/" + f + "/" + name + "." + f).c_str());
+  }
+};
+
+
+void drawPlotJobs(const std::vector< std::function<void()> >& jobs, const uint& nCores)
+{
+  const uint nWorkers = std::max(std::min(nCores, uint(jobs.size())), 1u);
+  if (nWorkers==1) {
+    for (const auto& job : jobs) { job(); }
+    return;
+  }
+  // Render the canvases in batch mode, each worker drawing a contiguous chunk of jobs
+  const bool isBatch = gROOT->IsBatch();
+  gROOT->SetBatch(kTRUE);
+  auto drawJobs = [&](int idx)
+  {
+    const size_t size = std::ceil(float(jobs.size())/float(nWorkers));
+    for (size_t i = idx*size; i < (idx+1)*size; i++) {
+      if (i>=jobs.size()) break;
+      jobs[i]();
+    }
+    return 0;
+  };
+  std::cout << "[INFO] Drawing " << jobs.size() << " plots using " << nWorkers << " workers" << std::endl;
+  ROOT::TProcessExecutor mpe(nWorkers);
+  mpe.Map(drawJobs, ROOT::TSeqI(nWorkers));
+  gROOT->SetBatch(isBatch);
+};
+
+
+void drawParametersGraph(GraphSextaMap2_t& graphMap, const std::string& outDir, const bool& isMC, const uint& nCores=1, const StringVector_t& formats=PLOTFORMAT)
 {
   //
   // Set Style
@@ -520,204 +681,202 @@ void drawParametersGraph(GraphSextaMap2_t& graphMap, const std::string& outDir,
   //
   std::cout << "[INFO] Drawing the output graphs" << std::endl;
   //
-  // Draw all graphs
+  // Collect the rendering jobs
+  std::vector< std::function<void()> > jobs;
   for (auto& o : graphMap) {
     for (auto& c : o.second) {
       for (auto& p : c.second) {
 	for (auto& pp : p.second) {
 	  for (auto& v : pp.second) {
-	    //
-	    const std::string& obj = o.first;
-	    const std::string& col = c.first;
-	    const std::string& var = v.first;
-	    const std::string& par = p.first;
-	    //
-	    auto& ggr = graphMap.at(obj).at(col).at(par).at(pp.first).at(var);
-	    //
-	    // Sort points
-	    for (auto& gr : ggr) { gr.second.Sort(); }
-	    //
-	    // Extract inclusive bin (largest width bin)
-	    int incBin = -1;
-	    double xMaxErr = -9999999999.;
-	    TGraphAsymmErrors incGraph;
-	    for (int i=0; i<ggr.at("Err_Stat").GetN(); i++) {
-	      const auto& xErr = ggr.at("Err_Stat").GetEXlow()[i];
-	      if (xErr > xMaxErr) {
-		incBin = i;
-		xMaxErr = xErr;
+	    // Sort points in the parent, so the graphs are sorted also after the forked workers are done
+	    for (auto& gr : v.second) { gr.second.Sort(); }
+	    jobs.push_back([&]() {
+	      //
+	      const std::string& obj = o.first;
+	      const std::string& col = c.first;
+	      const std::string& var = v.first;
+	      const std::string& par = p.first;
+	      //
+	      auto& ggr = graphMap.at(obj).at(col).at(par).at(pp.first).at(var);
+	      //
+	      // Extract inclusive bin (largest width bin)
+	      int incBin = -1;
+	      double xMaxErr = -9999999999.;
+	      TGraphAsymmErrors incGraph;
+	      for (int i=0; i<ggr.at("Err_Stat").GetN(); i++) {
+		const auto& xErr = ggr.at("Err_Stat").GetEXlow()[i];
+		if (xErr > xMaxErr) {
+		  incBin = i;
+		  xMaxErr = xErr;
+		}
 	      }
-	    }
-	    if (incBin>=0) {
-	      incGraph.Set(1);
-	      incGraph.SetPoint(0, 0.0, ggr.at("Err_Stat").GetY()[incBin]);
-	      incGraph.SetPointEYlow(0, ggr.at("Err_Stat").GetEYlow()[incBin]);
-	      incGraph.SetPointEYhigh(0, ggr.at("Err_Stat").GetEYhigh()[incBin]);
-	      for (auto& gr : ggr) { gr.second.RemovePoint(incBin); }
-	    }
-	    //
-	    // Exclude intermediate bins
-	    std::vector<int> excBin;
-	    for (int i=0; i<ggr.at("Err_Stat").GetN(); i++) {
-	      const auto& xVal1 = ggr.at("Err_Stat").GetX()[i];
-	      const auto& xErr1 = ggr.at("Err_Stat").GetEXlow()[i];
-	      for (int j=1; j<ggr.at("Err_Stat").GetN(); j++) {
-		const auto& xVal2 = ggr.at("Err_Stat").GetX()[j];
-		const auto& xErr2 = ggr.at("Err_Stat").GetEXlow()[j];
-		if (xVal1>xVal2 && xVal1-xErr1+0.001 < xVal2+xErr2) {
-		  const auto& excB = (xErr1>xErr2 ? i : j);
-		  if (xErr1!=xErr2 && !contain(excBin, excB)) { excBin.push_back(excB); }
+	      if (incBin>=0) {
+		incGraph.Set(1);
+		incGraph.SetPoint(0, 0.0, ggr.at("Err_Stat").GetY()[incBin]);
+		incGraph.SetPointEYlow(0, ggr.at("Err_Stat").GetEYlow()[incBin]);
+		incGraph.SetPointEYhigh(0, ggr.at("Err_Stat").GetEYhigh()[incBin]);
+		for (auto& gr : ggr) { gr.second.RemovePoint(incBin); }
+	      }
+	      //
+	      // Exclude intermediate bins
+	      std::vector<int> excBin;
+	      for (int i=0; i<ggr.at("Err_Stat").GetN(); i++) {
+		const auto& xVal1 = ggr.at("Err_Stat").GetX()[i];
+		const auto& xErr1 = ggr.at("Err_Stat").GetEXlow()[i];
+		for (int j=1; j<ggr.at("Err_Stat").GetN(); j++) {
+		  const auto& xVal2 = ggr.at("Err_Stat").GetX()[j];
+		  const auto& xErr2 = ggr.at("Err_Stat").GetEXlow()[j];
+		  if (xVal1>xVal2 && xVal1-xErr1+0.001 < xVal2+xErr2) {
+		    const auto& excB = (xErr1>xErr2 ? i : j);
+		    if (xErr1!=xErr2 && !contain(excBin, excB)) { excBin.push_back(excB); }
+		  }
 		}
 	      }
-	    }
-	    TGraphAsymmErrors midGraph; midGraph.Set(excBin.size());
-	    for (uint i=0; i<excBin.size(); i++) {
-	      const auto& excB = excBin[i];
-	      midGraph.SetPoint(i, ggr.at("Err_Stat").GetX()[excB], ggr.at("Err_Stat").GetY()[excB]);
-	      midGraph.SetPointEYlow(i, ggr.at("Err_Stat").GetEYlow()[excB]);
-	      midGraph.SetPointEYhigh(i, ggr.at("Err_Stat").GetEYhigh()[excB]);
-	      midGraph.SetPointEXlow(i, ggr.at("Err_Stat").GetEXlow()[excB]);
-	      midGraph.SetPointEXhigh(i, ggr.at("Err_Stat").GetEXhigh()[excB]);
-	    }
-	    for (int i=0; i<midGraph.GetN(); i++) {
-	      const auto& xVal1 = midGraph.GetX()[i];
-	      const auto& xErr1 = midGraph.GetEXlow()[i];
-	      for (int j=1; j<ggr.at("Err_Stat").GetN(); j++) {
-		const auto& xVal2 = ggr.at("Err_Stat").GetX()[j];
-		const auto& xErr2 = ggr.at("Err_Stat").GetEXlow()[j];
-		if (xVal1==xVal2 && xErr1==xErr2) {
-		  for (auto& gr : ggr) { gr.second.RemovePoint(j); }
-		  break;
+	      TGraphAsymmErrors midGraph; midGraph.Set(excBin.size());
+	      for (uint i=0; i<excBin.size(); i++) {
+		const auto& excB = excBin[i];
+		midGraph.SetPoint(i, ggr.at("Err_Stat").GetX()[excB], ggr.at("Err_Stat").GetY()[excB]);
+		midGraph.SetPointEYlow(i, ggr.at("Err_Stat").GetEYlow()[excB]);
+		midGraph.SetPointEYhigh(i, ggr.at("Err_Stat").GetEYhigh()[excB]);
+		midGraph.SetPointEXlow(i, ggr.at("Err_Stat").GetEXlow()[excB]);
+		midGraph.SetPointEXhigh(i, ggr.at("Err_Stat").GetEXhigh()[excB]);
+	      }
+	      for (int i=0; i<midGraph.GetN(); i++) {
+		const auto& xVal1 = midGraph.GetX()[i];
+		const auto& xErr1 = midGraph.GetEXlow()[i];
+		for (int j=1; j<ggr.at("Err_Stat").GetN(); j++) {
+		  const auto& xVal2 = ggr.at("Err_Stat").GetX()[j];
+		  const auto& xErr2 = ggr.at("Err_Stat").GetEXlow()[j];
+		  if (xVal1==xVal2 && xErr1==xErr2) {
+		    for (auto& gr : ggr) { gr.second.RemovePoint(j); }
+		    break;
+		  }
 		}
 	      }
-	    }
-	    //
-	    // Create Canvas
-	    TCanvas c("c", "c", 1000, 1000); c.cd();
-	    //
-	    // Create the Text Info
-	    TLatex tex; tex.SetNDC(); tex.SetTextSize(0.035); float dy = 0;
-	    std::vector< std::string > textToPrint;
-	    textToPrint.push_back(formatDecayLabel(var, obj));
-	    for (const auto& ppN : pp.first.first) { textToPrint.push_back(formatObsRange(ppN)); }
-	    for (const auto& ppN : pp.first.second) { textToPrint.push_back(formatObsRange(ppN)); }
-	    //
-	    // Declare the graph vector (for drawing with markers)
-	    uint iGr=0;
-	    std::vector<std::string> legLblV;
-	    std::vector< std::vector<TGraphAsymmErrors> > grDiVec;
-	    //
-	    auto& graph = pp.second.at(var);
-	    // Draw graph
-	    std::vector<TGraphAsymmErrors> grV;
-	    grV.push_back(graph.at("Err_Stat"));
-	    if (contain(graph, "Err_Syst")) {
-	      grV.push_back(graph.at("Err_Tot"));
-	      grV.push_back(graph.at("Err_Tot"));
-	    }
-	    grDiVec.push_back(grV);
-	    auto& grVec = grDiVec.back();
-	    if (contain(graph, "Err_Syst")) {
-	      for (int i=0; i<grVec[0].GetN(); i++) { double x, y; grVec[0].GetPoint(i, x, y); grVec[2].SetPoint(i, x, y+grVec[2].GetErrorYhigh(i)); grVec[3].SetPoint(i, x, y-grVec[3].GetErrorYlow(i)); }
-	    }
-	    for (auto& gr : grVec) { formatResultsGraph(gr, var, par, obj, col, COLOR[iGr]); }; iGr++;
-	    if (contain(graph, "Err_Syst")) {
-	      for (uint j=1; j<grVec.size(); j++) {
-		grVec[j].SetMarkerSize(0);
-		for (int i=0; i<grVec[j].GetN(); i++) { grVec[j].SetPointEYhigh(i, 0.0); grVec[j].SetPointEYlow(i, 0.0); }
-		for (int i=0; i<grVec[j].GetN(); i++) { grVec[j].SetPointEXhigh(i, 0.5*grVec[j].GetErrorXhigh(i)); grVec[j].SetPointEXlow(i, 0.5*grVec[j].GetErrorXlow(i)); }
+	      //
+	      // Create Canvas
+	      TCanvas c("c", "c", 1000, 1000); c.cd();
+	      //
+	      // Create the Text Info
+	      TLatex tex; tex.SetNDC(); tex.SetTextSize(0.035); float dy = 0;
+	      std::vector< std::string > textToPrint;
+	      textToPrint.push_back(formatDecayLabel(var, obj));
+	      for (const auto& ppN : pp.first.first) { textToPrint.push_back(formatObsRange(ppN)); }
+	      for (const auto& ppN : pp.first.second) { textToPrint.push_back(formatObsRange(ppN)); }
+	      //
+	      // Declare the graph vector (for drawing with markers)
+	      uint iGr=0;
+	      std::vector<std::string> legLblV;
+	      std::vector< std::vector<TGraphAsymmErrors> > grDiVec;
+	      //
+	      auto& graph = pp.second.at(var);
+	      // Draw graph
+	      std::vector<TGraphAsymmErrors> grV;
+	      grV.push_back(graph.at("Err_Stat"));
+	      if (contain(graph, "Err_Syst")) {
+		grV.push_back(graph.at("Err_Tot"));
+		grV.push_back(graph.at("Err_Tot"));
 	      }
-	    }
-	    if (incBin>=0) {
-	      incGraph.SetPoint(0, grVec[0].GetXaxis()->GetXmax()-0.1, incGraph.GetY()[0]);
-	      incGraph.SetMarkerColor(kRed);
-	      incGraph.SetMarkerSize(2.0);
-	      incGraph.SetMarkerStyle(21);
-	    }
-	    if (excBin.size()>0) {
-	      midGraph.SetMarkerColor(kBlue);
-	      midGraph.SetMarkerSize(2.0);
-	      midGraph.SetMarkerStyle(21);
-	    }
-	    //for (int i=0; i<grVec[0].GetN(); i++) { grVec[0].SetPointEXhigh(i, 0.0); grVec[0].SetPointEXlow(i, 0.0); }
-	    // Compute the weighted mean and RMS
-	    const auto& grStat = computeStats(grVec[0]);
-	    const auto meanVal = std::get<0>(grStat);
-	    const auto meanErr = std::get<1>(grStat);
-	    const auto RMS = std::get<2>(grStat);
-	    TLine line(grVec[0].GetXaxis()->GetXmin(), meanVal, grVec[0].GetXaxis()->GetXmax(), meanVal);
-	    line.SetLineStyle(7);
-	    line.SetLineColor(kBlack);
-	    line.SetLineWidth(4);
-	    // Draw the graphs
-	    grVec[0].Draw("ap");
-	    line.Draw("same");
-	    incGraph.Draw("samep");
-	    midGraph.Draw("samep");
-	    if (contain(graph, "Err_Syst")) {grVec[1].Draw("samep"); grVec[2].Draw("samep"); }
-	    grVec[0].Draw("samep");
-	    // Add legend text
-	    std::string legLbl = ""; for (const auto& ppN : pp.first.first) { legLbl += formatObsRange(ppN)+" , "; };
-	    if (legLbl.find(" , ")!=std::string::npos) { legLbl.erase(legLbl.find(" , "), 3); }
-	    legLblV.push_back(legLbl);
-	    //
-	    // Initialize the Legend
-	    std::unique_ptr<TLegend> leg;
-	    if (legLblV.size()>1) {
-	      // Define the position and size of the legend
-	      double xmin = 0.49 , xmax = 0.66 , ymin = 0.58 , ymax = 0.69 , legSize = 0.047;
-	      ymin = std::max(ymax-legLblV.size()*legSize*1.2, ymin);
-	      leg.reset(new TLegend(xmin, ymin, xmax, ymax));
-	      for (uint i=0; i<legLblV.size(); i++) { formatLegendEntry(*leg->AddEntry(&grDiVec[i][0], legLblV[i].c_str(), "p"), legSize); }
-	      // Draw the Legend
-	      leg->Draw("same");
-	    }
-	    // Update
-	    c.Modified(); c.Update();
-	    // Draw the text
-	    tex.SetTextSize(0.055); tex.DrawLatex(0.22, 0.84, textToPrint[0].c_str());
-	    tex.SetTextSize(0.060); tex.SetTextFont(61); tex.DrawLatex(0.78, 0.84, "CMS"); tex.SetTextFont(62);
-	    tex.SetTextSize(0.046); tex.SetTextFont(52); tex.DrawLatex(0.69, 0.79, "Preliminary"); tex.SetTextFont(62);
-	    for (uint i=1; i<textToPrint.size(); i++) { tex.SetTextSize(0.045); tex.DrawLatex(0.22, 0.76-dy, textToPrint[i].c_str()); dy+=0.060; }
-	    if (var=="Cross_Section") { tex.SetTextSize(0.030); tex.DrawLatex(0.25, 0.17, "Lumi. uncertainty not shown"); }
-	    tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.74, Form("Mean: %.3f #pm %.3f", meanVal, meanErr));
-	    tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.69, Form("RMS: %.3f", RMS));
-	    if (incBin>=0) { tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.64, Form("Incl.: %.3f #pm %.3f", incGraph.GetY()[0], std::max(incGraph.GetEYlow()[0], incGraph.GetEYhigh()[0]))); }
-	    // Update
-	    c.Modified(); c.Update(); // Pure paranoia
-	    //
-	    // set the CMS style
-	    StringVector_t lumiLabels; getLumiLabels(lumiLabels, "", col, isMC);
-	    CMS_lumi(&c, 33, (" "+lumiLabels[0]), lumiLabels[1], false, 0.65, false);
-	    // Update
-	    c.Modified(); c.Update(); // Pure paranoia
-	    //
-	    // Create Output Directory
-	    const std::string& plotDir = outDir+"/Plots/"+par;
-	    makeDir(plotDir + "/png/");
-	    makeDir(plotDir + "/pdf/");
-	    makeDir(plotDir + "/root/");
-	    makeDir(plotDir + "/C/");
-	    //
-	    // Save Canvas
-	    const std::string& grName = v.second.at("Err_Stat").GetName();
-	    const auto& name = grName.substr(0, grName.rfind("_Err_Stat"));
-	    c.SaveAs((plotDir + "/png/"  + name + ".png" ).c_str());
-	    c.SaveAs((plotDir + "/pdf/"  + name + ".pdf" ).c_str());
-	    c.SaveAs((plotDir + "/root/" + name + ".root").c_str());
-	    //c.SaveAs((plotDir + "/C/"    + name + ".C"   ).c_str());
-	    //
-	    // Clean up memory
-	    c.Clear(); c.Close();
+	      grDiVec.push_back(grV);
+	      auto& grVec = grDiVec.back();
+	      if (contain(graph, "Err_Syst")) {
+		for (int i=0; i<grVec[0].GetN(); i++) { double x, y; grVec[0].GetPoint(i, x, y); grVec[2].SetPoint(i, x, y+grVec[2].GetErrorYhigh(i)); grVec[3].SetPoint(i, x, y-grVec[3].GetErrorYlow(i)); }
+	      }
+	      for (auto& gr : grVec) { formatResultsGraph(gr, var, par, obj, col, COLOR[iGr]); }; iGr++;
+	      if (contain(graph, "Err_Syst")) {
+		for (uint j=1; j<grVec.size(); j++) {
+		  grVec[j].SetMarkerSize(0);
+		  for (int i=0; i<grVec[j].GetN(); i++) { grVec[j].SetPointEYhigh(i, 0.0); grVec[j].SetPointEYlow(i, 0.0); }
+		  for (int i=0; i<grVec[j].GetN(); i++) { grVec[j].SetPointEXhigh(i, 0.5*grVec[j].GetErrorXhigh(i)); grVec[j].SetPointEXlow(i, 0.5*grVec[j].GetErrorXlow(i)); }
+		}
+	      }
+	      if (incBin>=0) {
+		incGraph.SetPoint(0, grVec[0].GetXaxis()->GetXmax()-0.1, incGraph.GetY()[0]);
+		incGraph.SetMarkerColor(kRed);
+		incGraph.SetMarkerSize(2.0);
+		incGraph.SetMarkerStyle(21);
+	      }
+	      if (excBin.size()>0) {
+		midGraph.SetMarkerColor(kBlue);
+		midGraph.SetMarkerSize(2.0);
+		midGraph.SetMarkerStyle(21);
+	      }
+	      //for (int i=0; i<grVec[0].GetN(); i++) { grVec[0].SetPointEXhigh(i, 0.0); grVec[0].SetPointEXlow(i, 0.0); }
+	      // Compute the weighted mean and RMS
+	      const auto& grStat = computeStats(grVec[0]);
+	      const auto meanVal = std::get<0>(grStat);
+	      const auto meanErr = std::get<1>(grStat);
+	      const auto RMS = std::get<2>(grStat);
+	      TLine line(grVec[0].GetXaxis()->GetXmin(), meanVal, grVec[0].GetXaxis()->GetXmax(), meanVal);
+	      line.SetLineStyle(7);
+	      line.SetLineColor(kBlack);
+	      line.SetLineWidth(4);
+	      // Draw the graphs
+	      grVec[0].Draw("ap");
+	      line.Draw("same");
+	      incGraph.Draw("samep");
+	      midGraph.Draw("samep");
+	      if (contain(graph, "Err_Syst")) {grVec[1].Draw("samep"); grVec[2].Draw("samep"); }
+	      grVec[0].Draw("samep");
+	      // Add legend text
+	      std::string legLbl = ""; for (const auto& ppN : pp.first.first) { legLbl += formatObsRange(ppN)+" , "; };
+	      if (legLbl.find(" , ")!=std::string::npos) { legLbl.erase(legLbl.find(" , "), 3); }
+	      legLblV.push_back(legLbl);
+	      //
+	      // Initialize the Legend
+	      std::unique_ptr<TLegend> leg;
+	      if (legLblV.size()>1) {
+		// Define the position and size of the legend
+		double xmin = 0.49 , xmax = 0.66 , ymin = 0.58 , ymax = 0.69 , legSize = 0.047;
+		ymin = std::max(ymax-legLblV.size()*legSize*1.2, ymin);
+		leg.reset(new TLegend(xmin, ymin, xmax, ymax));
+		for (uint i=0; i<legLblV.size(); i++) { formatLegendEntry(*leg->AddEntry(&grDiVec[i][0], legLblV[i].c_str(), "p"), legSize); }
+		// Draw the Legend
+		leg->Draw("same");
+	      }
+	      // Update
+	      c.Modified(); c.Update();
+	      // Draw the text
+	      tex.SetTextSize(0.055); tex.DrawLatex(0.22, 0.84, textToPrint[0].c_str());
+	      tex.SetTextSize(0.060); tex.SetTextFont(61); tex.DrawLatex(0.78, 0.84, "CMS"); tex.SetTextFont(62);
+	      tex.SetTextSize(0.046); tex.SetTextFont(52); tex.DrawLatex(0.69, 0.79, "Preliminary"); tex.SetTextFont(62);
+	      for (uint i=1; i<textToPrint.size(); i++) { tex.SetTextSize(0.045); tex.DrawLatex(0.22, 0.76-dy, textToPrint[i].c_str()); dy+=0.060; }
+	      if (var=="Cross_Section") { tex.SetTextSize(0.030); tex.DrawLatex(0.25, 0.17, "Lumi. uncertainty not shown"); }
+	      tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.74, Form("Mean: %.3f #pm %.3f", meanVal, meanErr));
+	      tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.69, Form("RMS: %.3f", RMS));
+	      if (incBin>=0) { tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.64, Form("Incl.: %.3f #pm %.3f", incGraph.GetY()[0], std::max(incGraph.GetEYlow()[0], incGraph.GetEYhigh()[0]))); }
+	      // Update
+	      c.Modified(); c.Update(); // Pure paranoia
+	      //
+	      // set the CMS style
+	      StringVector_t lumiLabels; getLumiLabels(lumiLabels, "", col, isMC);
+	      CMS_lumi(&c, 33, (" "+lumiLabels[0]), lumiLabels[1], false, 0.65, false);
+	      // Update
+	      c.Modified(); c.Update(); // Pure paranoia
+	      //
+	      // Define Output Directory
+	      const std::string& plotDir = outDir+"/Plots/"+par;
+	      //
+	      // Save Canvas
+	      const std::string& grName = v.second.at("Err_Stat").GetName();
+	      const auto& name = grName.substr(0, grName.rfind("_Err_Stat"));
+	      saveCanvas(c, plotDir, name, formats);
+	      //
+	      // Clean up memory
+	      c.Clear(); c.Close();
+	    });
 	  }
 	}
       }
     }
   }
+  //
+  // Render the graphs
+  drawPlotJobs(jobs, nCores);
 };
 
 
-void compareObjectGraph(GraphSextaMap2_t& graphMap, const std::string& outDir, const bool& isMC, const StringVector_t& objTags)
+void compareObjectGraph(GraphSextaMap2_t& graphMap, const std::string& outDir, const bool& isMC, const StringVector_t& objTags, const uint& nCores=1, const StringVector_t& formats=PLOTFORMAT)
 {
   //
   // Set Style
@@ -728,224 +887,223 @@ void compareObjectGraph(GraphSextaMap2_t& graphMap, const std::string& outDir, c
   // Main object
   const auto& mainObj = objTags[0];
   //
-  // Draw all graphs
+  // Collect the rendering jobs
+  std::vector< std::function<void()> > jobs;
   for (auto& c : graphMap.at(mainObj)) {
     for (auto& p : c.second) {
       for (auto& pp : p.second) {
 	for (auto& v : pp.second) {
-	  //
-	  const std::string& col = c.first;
-	  const std::string& var = v.first;
-	  const std::string& par = p.first;
-	  //
-	  const auto mainObjGraph = graphMap.at(mainObj).at(col).at(par).at(pp.first).at(var);
-	  //
-	  for (const auto& obj : objTags) {
-	    if (obj==mainObj) continue;
-	    //
-	    // Create Canvas
-	    TCanvas c("c", "c", 1000, 1000); c.cd();
-	    //
-	    // Create the Text Info
-	    TLatex tex; tex.SetNDC(); tex.SetTextSize(0.035); float dy = 0;
-	    std::vector< std::string > textToPrint;
-	    std::string sampleLabel = formatObjName(obj);
-	    sampleLabel = (obj.rfind("Ups",0)==0 ? "#Upsilon(nS)" : (obj.rfind("Psi",0)==0 ? "#psi(nS)" : sampleLabel));
-	    sampleLabel += "#rightarrow #mu^{+}#mu^{#font[122]{\55}}";
-	    textToPrint.push_back(sampleLabel);
-	    for (const auto& ppN : pp.first.first) { textToPrint.push_back(formatObsRange(ppN)); }
-	    for (const auto& ppN : pp.first.second) { textToPrint.push_back(formatObsRange(ppN)); }
-	    //
-	    // Declare the graph vector (for drawing with markers)
-	    uint iGr=0;
-	    std::vector<std::string> legLblV;
-	    std::vector< std::vector<TGraphAsymmErrors> > grDiVec;
+	  jobs.push_back([&]() {
 	    //
-	    auto& objGraph = graphMap.at(obj).at(col).at(par).at(pp.first).at(var);
+	    const std::string& col = c.first;
+	    const std::string& var = v.first;
+	    const std::string& par = p.first;
 	    //
-	    auto graph = objGraph;
+	    const auto mainObjGraph = graphMap.at(mainObj).at(col).at(par).at(pp.first).at(var);
 	    //
-	    for (const auto& gr : mainObjGraph) {
-	      const auto& mObjGr = gr.second;
-	      auto& objGr = graph.at(gr.first);
-	      for (int i=0; i<mObjGr.GetN(); i++) {
-		const auto& mVal = (mObjGr.GetY()[i]!=0.0 ? mObjGr.GetY()[i] : 1E-9);
-		const auto& oVal = objGr.GetY()[i]/mVal;
-		objGr.SetPoint(i, objGr.GetX()[i], oVal);
-		const auto& mErrUp = mObjGr.GetEYhigh()[i];
-		const auto& mErrDw = mObjGr.GetEYlow()[i];
-		const auto& ooVal = (objGr.GetY()[i]!=0.0 ? objGr.GetY()[i] : 1E-9);
-		const auto& oErrUp = oVal*std::sqrt( std::pow(mErrUp/mVal, 2.0) + std::pow(objGr.GetEYhigh()[i]/ooVal, 2.0) );
-		const auto& oErrDw = oVal*std::sqrt( std::pow(mErrDw/mVal, 2.0) + std::pow(objGr.GetEYlow()[i]/ooVal, 2.0) );
-		objGr.SetPointEYhigh(i, oErrUp);
-		objGr.SetPointEYlow (i, oErrDw);
+	    for (const auto& obj : objTags) {
+	      if (obj==mainObj) continue;
+	      //
+	      // Create Canvas
+	      TCanvas c("c", "c", 1000, 1000); c.cd();
+	      //
+	      // Create the Text Info
+	      TLatex tex; tex.SetNDC(); tex.SetTextSize(0.035); float dy = 0;
+	      std::vector< std::string > textToPrint;
+	      std::string sampleLabel = formatObjName(obj);
+	      sampleLabel = (obj.rfind("Ups",0)==0 ? "#Upsilon(nS)" : (obj.rfind("Psi",0)==0 ? "#psi(nS)" : sampleLabel));
+	      sampleLabel += "#rightarrow #mu^{+}#mu^{#font[122]{\55}}";
+	      textToPrint.push_back(sampleLabel);
+	      for (const auto& ppN : pp.first.first) { textToPrint.push_back(formatObsRange(ppN)); }
+	      for (const auto& ppN : pp.first.second) { textToPrint.push_back(formatObsRange(ppN)); }
+	      //
+	      // Declare the graph vector (for drawing with markers)
+	      uint iGr=0;
+	      std::vector<std::string> legLblV;
+	      std::vector< std::vector<TGraphAsymmErrors> > grDiVec;
+	      //
+	      auto& objGraph = graphMap.at(obj).at(col).at(par).at(pp.first).at(var);
+	      //
+	      auto graph = objGraph;
+	      //
+	      for (const auto& gr : mainObjGraph) {
+		const auto& mObjGr = gr.second;
+		auto& objGr = graph.at(gr.first);
+		for (int i=0; i<mObjGr.GetN(); i++) {
+		  const auto& mVal = (mObjGr.GetY()[i]!=0.0 ? mObjGr.GetY()[i] : 1E-9);
+		  const auto& oVal = objGr.GetY()[i]/mVal;
+		  objGr.SetPoint(i, objGr.GetX()[i], oVal);
+		  const auto& mErrUp = mObjGr.GetEYhigh()[i];
+		  const auto& mErrDw = mObjGr.GetEYlow()[i];
+		  const auto& ooVal = (objGr.GetY()[i]!=0.0 ? objGr.GetY()[i] : 1E-9);
+		  const auto& oErrUp = oVal*std::sqrt( std::pow(mErrUp/mVal, 2.0) + std::pow(objGr.GetEYhigh()[i]/ooVal, 2.0) );
+		  const auto& oErrDw = oVal*std::sqrt( std::pow(mErrDw/mVal, 2.0) + std::pow(objGr.GetEYlow()[i]/ooVal, 2.0) );
+		  objGr.SetPointEYhigh(i, oErrUp);
+		  objGr.SetPointEYlow (i, oErrDw);
+		}
 	      }
-	    }
-	    //
-	    // Sort points
-	    for (auto& gr : graph) { gr.second.Sort(); }
-	    //
-	    // Extract inclusive bin (largest width bin)
-	    int incBin = -1;
-	    double xMaxErr = -9999999999.;
-	    TGraphAsymmErrors incGraph;
-	    for (int i=0; i<graph.at("Err_Stat").GetN(); i++) {
-	      const auto& xErr = graph.at("Err_Stat").GetEXlow()[i];
-	      if (xErr > xMaxErr) {
-		incBin = i;
-		xMaxErr = xErr;
+	      //
+	      // Sort points
+	      for (auto& gr : graph) { gr.second.Sort(); }
+	      //
+	      // Extract inclusive bin (largest width bin)
+	      int incBin = -1;
+	      double xMaxErr = -9999999999.;
+	      TGraphAsymmErrors incGraph;
+	      for (int i=0; i<graph.at("Err_Stat").GetN(); i++) {
+		const auto& xErr = graph.at("Err_Stat").GetEXlow()[i];
+		if (xErr > xMaxErr) {
+		  incBin = i;
+		  xMaxErr = xErr;
+		}
 	      }
-	    }
-	    if (incBin>=0) {
-	      incGraph.Set(1);
-	      incGraph.SetPoint(0, 0.0, graph.at("Err_Stat").GetY()[incBin]);
-	      incGraph.SetPointEYlow(0, graph.at("Err_Stat").GetEYlow()[incBin]);
-	      incGraph.SetPointEYhigh(0, graph.at("Err_Stat").GetEYhigh()[incBin]);
-	      for (auto& gr : graph) { gr.second.RemovePoint(incBin); }
-	    }
-	    //
-	    // Exclude intermediate bins
-	    std::vector<int> excBin;
-	    for (int i=0; i<graph.at("Err_Stat").GetN(); i++) {
-	      const auto& xVal1 = graph.at("Err_Stat").GetX()[i];
-	      const auto& xErr1 = graph.at("Err_Stat").GetEXlow()[i];
-	      for (int j=1; j<graph.at("Err_Stat").GetN(); j++) {
-		const auto& xVal2 = graph.at("Err_Stat").GetX()[j];
-		const auto& xErr2 = graph.at("Err_Stat").GetEXlow()[j];
-		if (xVal1>xVal2 && xVal1-xErr1+0.001 < xVal2+xErr2) {
-		  const auto& excB = (xErr1>xErr2 ? i : j);
-		  if (xErr1!=xErr2 && !contain(excBin, excB)) { excBin.push_back(excB); }
+	      if (incBin>=0) {
+		incGraph.Set(1);
+		incGraph.SetPoint(0, 0.0, graph.at("Err_Stat").GetY()[incBin]);
+		incGraph.SetPointEYlow(0, graph.at("Err_Stat").GetEYlow()[incBin]);
+		incGraph.SetPointEYhigh(0, graph.at("Err_Stat").GetEYhigh()[incBin]);
+		for (auto& gr : graph) { gr.second.RemovePoint(incBin); }
+	      }
+	      //
+	      // Exclude intermediate bins
+	      std::vector<int> excBin;
+	      for (int i=0; i<graph.at("Err_Stat").GetN(); i++) {
+		const auto& xVal1 = graph.at("Err_Stat").GetX()[i];
+		const auto& xErr1 = graph.at("Err_Stat").GetEXlow()[i];
+		for (int j=1; j<graph.at("Err_Stat").GetN(); j++) {
+		  const auto& xVal2 = graph.at("Err_Stat").GetX()[j];
+		  const auto& xErr2 = graph.at("Err_Stat").GetEXlow()[j];
+		  if (xVal1>xVal2 && xVal1-xErr1+0.001 < xVal2+xErr2) {
+		    const auto& excB = (xErr1>xErr2 ? i : j);
+		    if (xErr1!=xErr2 && !contain(excBin, excB)) { excBin.push_back(excB); }
+		  }
 		}
 	      }
-	    }
-	    TGraphAsymmErrors midGraph; midGraph.Set(excBin.size());
-	    for (uint i=0; i<excBin.size(); i++) {
-	      const auto& excB = excBin[i];
-	      midGraph.SetPoint(i, graph.at("Err_Stat").GetX()[excB], graph.at("Err_Stat").GetY()[excB]);
-	      midGraph.SetPointEYlow(i, graph.at("Err_Stat").GetEYlow()[excB]);
-	      midGraph.SetPointEYhigh(i, graph.at("Err_Stat").GetEYhigh()[excB]);
-	      midGraph.SetPointEXlow(i, graph.at("Err_Stat").GetEXlow()[excB]);
-	      midGraph.SetPointEXhigh(i, graph.at("Err_Stat").GetEXhigh()[excB]);
-	    }
-	    for (int i=0; i<midGraph.GetN(); i++) {
-	      const auto& xVal1 = midGraph.GetX()[i];
-	      const auto& xErr1 = midGraph.GetEXlow()[i];
-	      for (int j=1; j<graph.at("Err_Stat").GetN(); j++) {
-		const auto& xVal2 = graph.at("Err_Stat").GetX()[j];
-		const auto& xErr2 = graph.at("Err_Stat").GetEXlow()[j];
-		if (xVal1==xVal2 && xErr1==xErr2) {
-		  for (auto& gr : graph) { gr.second.RemovePoint(j); }
-		  break;
+	      TGraphAsymmErrors midGraph; midGraph.Set(excBin.size());
+	      for (uint i=0; i<excBin.size(); i++) {
+		const auto& excB = excBin[i];
+		midGraph.SetPoint(i, graph.at("Err_Stat").GetX()[excB], graph.at("Err_Stat").GetY()[excB]);
+		midGraph.SetPointEYlow(i, graph.at("Err_Stat").GetEYlow()[excB]);
+		midGraph.SetPointEYhigh(i, graph.at("Err_Stat").GetEYhigh()[excB]);
+		midGraph.SetPointEXlow(i, graph.at("Err_Stat").GetEXlow()[excB]);
+		midGraph.SetPointEXhigh(i, graph.at("Err_Stat").GetEXhigh()[excB]);
+	      }
+	      for (int i=0; i<midGraph.GetN(); i++) {
+		const auto& xVal1 = midGraph.GetX()[i];
+		const auto& xErr1 = midGraph.GetEXlow()[i];
+		for (int j=1; j<graph.at("Err_Stat").GetN(); j++) {
+		  const auto& xVal2 = graph.at("Err_Stat").GetX()[j];
+		  const auto& xErr2 = graph.at("Err_Stat").GetEXlow()[j];
+		  if (xVal1==xVal2 && xErr1==xErr2) {
+		    for (auto& gr : graph) { gr.second.RemovePoint(j); }
+		    break;
+		  }
 		}
 	      }
-	    }
-	    // Draw graph
-	    std::vector<TGraphAsymmErrors> grV;
-	    grV.push_back(graph.at("Err_Stat"));
-	    if (contain(graph, "Err_Syst")) {
-	      grV.push_back(graph.at("Err_Tot"));
-	      grV.push_back(graph.at("Err_Tot"));
-	    }
-	    grDiVec.push_back(grV);
-	    auto& grVec = grDiVec.back();
-	    if (contain(graph, "Err_Syst")) {
-	      for (int i=0; i<grVec[0].GetN(); i++) { double x, y; grVec[0].GetPoint(i, x, y); grVec[2].SetPoint(i, x, y+grVec[2].GetErrorYhigh(i)); grVec[3].SetPoint(i, x, y-grVec[3].GetErrorYlow(i)); }
-	    }
-	    for (auto& gr : grVec) { formatResultsGraph(gr, var, par, obj, col, COLOR[iGr], true); }; iGr++;
-	    if (contain(graph, "Err_Syst")) {
-	      for (uint j=1; j<grVec.size(); j++) {
-		grVec[j].SetMarkerSize(0);
-		for (int i=0; i<grVec[j].GetN(); i++) { grVec[j].SetPointEYhigh(i, 0.0); grVec[j].SetPointEYlow(i, 0.0); }
-		for (int i=0; i<grVec[j].GetN(); i++) { grVec[j].SetPointEXhigh(i, 0.5*grVec[j].GetErrorXhigh(i)); grVec[j].SetPointEXlow(i, 0.5*grVec[j].GetErrorXlow(i)); }
+	      // Draw graph
+	      std::vector<TGraphAsymmErrors> grV;
+	      grV.push_back(graph.at("Err_Stat"));
+	      if (contain(graph, "Err_Syst")) {
+		grV.push_back(graph.at("Err_Tot"));
+		grV.push_back(graph.at("Err_Tot"));
 	      }
+	      grDiVec.push_back(grV);
+	      auto& grVec = grDiVec.back();
+	      if (contain(graph, "Err_Syst")) {
+		for (int i=0; i<grVec[0].GetN(); i++) { double x, y; grVec[0].GetPoint(i, x, y); grVec[2].SetPoint(i, x, y+grVec[2].GetErrorYhigh(i)); grVec[3].SetPoint(i, x, y-grVec[3].GetErrorYlow(i)); }
+	      }
+	      for (auto& gr : grVec) { formatResultsGraph(gr, var, par, obj, col, COLOR[iGr], true); }; iGr++;
+	      if (contain(graph, "Err_Syst")) {
+		for (uint j=1; j<grVec.size(); j++) {
+		  grVec[j].SetMarkerSize(0);
+		  for (int i=0; i<grVec[j].GetN(); i++) { grVec[j].SetPointEYhigh(i, 0.0); grVec[j].SetPointEYlow(i, 0.0); }
+		  for (int i=0; i<grVec[j].GetN(); i++) { grVec[j].SetPointEXhigh(i, 0.5*grVec[j].GetErrorXhigh(i)); grVec[j].SetPointEXlow(i, 0.5*grVec[j].GetErrorXlow(i)); }
+		}
+	      }
+	      if (incBin>=0) {
+		incGraph.SetPoint(0, grVec[0].GetXaxis()->GetXmax()-0.1, incGraph.GetY()[0]);
+		incGraph.SetMarkerColor(kRed);
+		incGraph.SetMarkerSize(2.0);
+		incGraph.SetMarkerStyle(21);
+	      }
+	      if (excBin.size()>0) {
+		midGraph.SetMarkerColor(kBlue);
+		midGraph.SetMarkerSize(2.0);
+		midGraph.SetMarkerStyle(21);
+	      }
+	      //for (int i=0; i<grVec[0].GetN(); i++) { grVec[0].SetPointEXhigh(i, 0.0); grVec[0].SetPointEXlow(i, 0.0); }
+	      // Compute the weighted mean and RMS
+	      const auto& grStat = computeStats(grVec[0]);
+	      const auto meanVal = std::get<0>(grStat);
+	      const auto meanErr = std::get<1>(grStat);
+	      const auto RMS = std::get<2>(grStat);
+	      TLine line(grVec[0].GetXaxis()->GetXmin(), meanVal, grVec[0].GetXaxis()->GetXmax(), meanVal);
+	      line.SetLineStyle(7);
+	      line.SetLineColor(kBlack);
+	      line.SetLineWidth(4);
+	      // Draw the graphs
+	      grVec[0].Draw("ap");
+	      incGraph.Draw("samep");
+	      midGraph.Draw("samep");
+	      line.Draw("same");
+	      if (contain(graph, "Err_Syst")) {grVec[1].Draw("samep"); grVec[2].Draw("samep"); }
+	      grVec[0].Draw("samep");
+	      // Add legend text
+	      std::string legLbl = ""; for (const auto& ppN : pp.first.first) { legLbl += formatObsRange(ppN)+" , "; };
+	      if (legLbl.find(" , ")!=std::string::npos) { legLbl.erase(legLbl.find(" , "), 3); }
+	      legLblV.push_back(legLbl);
+	      //
+	      // Initialize the Legend
+	      std::unique_ptr<TLegend> leg;
+	      if (legLblV.size()>1) {
+		// Define the position and size of the legend
+		double xmin = 0.49 , xmax = 0.66 , ymin = 0.58 , ymax = 0.69 , legSize = 0.047;
+		ymin = std::max(ymax-legLblV.size()*legSize*1.2, ymin);
+		leg.reset(new TLegend(xmin, ymin, xmax, ymax));
+		for (uint i=0; i<legLblV.size(); i++) { formatLegendEntry(*leg->AddEntry(&grDiVec[i][0], legLblV[i].c_str(), "p"), legSize); }
+		// Draw the Legend
+		leg->Draw("same");
+	      }
+	      // Update
+	      c.Modified(); c.Update();
+	      // Draw the text
+	      tex.SetTextSize(0.055); tex.DrawLatex(0.22, 0.84, textToPrint[0].c_str());
+	      tex.SetTextSize(0.060); tex.SetTextFont(61); tex.DrawLatex(0.78, 0.84, "CMS"); tex.SetTextFont(62);
+	      tex.SetTextSize(0.046); tex.SetTextFont(52); tex.DrawLatex(0.69, 0.79, "Preliminary"); tex.SetTextFont(62);
+	      for (uint i=1; i<textToPrint.size(); i++) { tex.SetTextSize(0.045); tex.DrawLatex(0.22, 0.76-dy, textToPrint[i].c_str()); dy+=0.060; }
+	      if (var=="Cross_Section") { tex.SetTextSize(0.030); tex.DrawLatex(0.25, 0.17, "Lumi. uncertainty not shown"); }
+	      tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.74, Form("Mean: %.3f #pm %.3f", meanVal, meanErr));
+	      tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.69, Form("RMS: %.3f", RMS));
+	      if (incBin>=0) { tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.64, Form("Incl.: %.3f #pm %.3f", incGraph.GetY()[0], std::max(incGraph.GetEYlow()[0], incGraph.GetEYhigh()[0]))); }
+	      if (var.rfind("Sigma",0)==0 || var=="m") { tex.SetTextSize(0.030); tex.DrawLatex(0.62, 0.58, Form("PDG mass ratio: %.2f", ANA::MASS.at(obj).at("Val")/ANA::MASS.at(mainObj).at("Val"))); }
+	      // Update
+	      c.Modified(); c.Update(); // Pure paranoia
+	      //
+	      // set the CMS style
+	      StringVector_t lumiLabels; getLumiLabels(lumiLabels, "", col, isMC);
+	      CMS_lumi(&c, 33, (" "+lumiLabels[0]), lumiLabels[1], false, 0.65, false);
+	      // Update
+	      c.Modified(); c.Update(); // Pure paranoia
+	      //
+	      // Define Output Directory
+	      const std::string& plotDir = outDir+"/Plots/"+par;
+	      //
+	      // Save Canvas
+	      const std::string& grName = v.second.at("Err_Stat").GetName();
+	      const auto& name = grName.substr(0, grName.rfind("_Err_Stat"));
+	      saveCanvas(c, plotDir, name, formats);
+	      //
+	      // Clean up memory
+	      c.Clear(); c.Close();
 	    }
-	    if (incBin>=0) {
-	      incGraph.SetPoint(0, grVec[0].GetXaxis()->GetXmax()-0.1, incGraph.GetY()[0]);
-	      incGraph.SetMarkerColor(kRed);
-	      incGraph.SetMarkerSize(2.0);
-	      incGraph.SetMarkerStyle(21);
-	    }
-	    if (excBin.size()>0) {
-	      midGraph.SetMarkerColor(kBlue);
-	      midGraph.SetMarkerSize(2.0);
-	      midGraph.SetMarkerStyle(21);
-	    }
-	    //for (int i=0; i<grVec[0].GetN(); i++) { grVec[0].SetPointEXhigh(i, 0.0); grVec[0].SetPointEXlow(i, 0.0); }
-	    // Compute the weighted mean and RMS
-	    const auto& grStat = computeStats(grVec[0]);
-	    const auto meanVal = std::get<0>(grStat);
-	    const auto meanErr = std::get<1>(grStat);
-	    const auto RMS = std::get<2>(grStat);
-	    TLine line(grVec[0].GetXaxis()->GetXmin(), meanVal, grVec[0].GetXaxis()->GetXmax(), meanVal);
-	    line.SetLineStyle(7);
-	    line.SetLineColor(kBlack);
-	    line.SetLineWidth(4);
-	    // Draw the graphs
-	    grVec[0].Draw("ap");
-	    incGraph.Draw("samep");
-	    midGraph.Draw("samep");
-	    line.Draw("same");
-	    if (contain(graph, "Err_Syst")) {grVec[1].Draw("samep"); grVec[2].Draw("samep"); }
-	    grVec[0].Draw("samep");
-	    // Add legend text
-	    std::string legLbl = ""; for (const auto& ppN : pp.first.first) { legLbl += formatObsRange(ppN)+" , "; };
-	    if (legLbl.find(" , ")!=std::string::npos) { legLbl.erase(legLbl.find(" , "), 3); }
-	    legLblV.push_back(legLbl);
-	    //
-	    // Initialize the Legend
-	    std::unique_ptr<TLegend> leg;
-	    if (legLblV.size()>1) {
-	      // Define the position and size of the legend
-	      double xmin = 0.49 , xmax = 0.66 , ymin = 0.58 , ymax = 0.69 , legSize = 0.047;
-	      ymin = std::max(ymax-legLblV.size()*legSize*1.2, ymin);
-	      leg.reset(new TLegend(xmin, ymin, xmax, ymax));
-	      for (uint i=0; i<legLblV.size(); i++) { formatLegendEntry(*leg->AddEntry(&grDiVec[i][0], legLblV[i].c_str(), "p"), legSize); }
-	      // Draw the Legend
-	      leg->Draw("same");
-	    }
-	    // Update
-	    c.Modified(); c.Update();
-	    // Draw the text
-	    tex.SetTextSize(0.055); tex.DrawLatex(0.22, 0.84, textToPrint[0].c_str());
-	    tex.SetTextSize(0.060); tex.SetTextFont(61); tex.DrawLatex(0.78, 0.84, "CMS"); tex.SetTextFont(62);
-	    tex.SetTextSize(0.046); tex.SetTextFont(52); tex.DrawLatex(0.69, 0.79, "Preliminary"); tex.SetTextFont(62);
-	    for (uint i=1; i<textToPrint.size(); i++) { tex.SetTextSize(0.045); tex.DrawLatex(0.22, 0.76-dy, textToPrint[i].c_str()); dy+=0.060; }
-	    if (var=="Cross_Section") { tex.SetTextSize(0.030); tex.DrawLatex(0.25, 0.17, "Lumi. uncertainty not shown"); }
-	    tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.74, Form("Mean: %.3f #pm %.3f", meanVal, meanErr));
-	    tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.69, Form("RMS: %.3f", RMS));
-	    if (incBin>=0) { tex.SetTextSize(0.030); tex.DrawLatex(0.66, 0.64, Form("Incl.: %.3f #pm %.3f", incGraph.GetY()[0], std::max(incGraph.GetEYlow()[0], incGraph.GetEYhigh()[0]))); }
-	    if (var.rfind("Sigma",0)==0 || var=="m") { tex.SetTextSize(0.030); tex.DrawLatex(0.62, 0.58, Form("PDG mass ratio: %.2f", ANA::MASS.at(obj).at("Val")/ANA::MASS.at(mainObj).at("Val"))); }
-	    // Update
-	    c.Modified(); c.Update(); // Pure paranoia
-	    //
-	    // set the CMS style
-	    StringVector_t lumiLabels; getLumiLabels(lumiLabels, "", col, isMC);
-	    CMS_lumi(&c, 33, (" "+lumiLabels[0]), lumiLabels[1], false, 0.65, false);
-	    // Update
-	    c.Modified(); c.Update(); // Pure paranoia
-	    //
-	    // Create Output Directory
-	    const std::string& plotDir = outDir+"/Plots/"+par;
-	    makeDir(plotDir + "/png/");
-	    makeDir(plotDir + "/pdf/");
-	    makeDir(plotDir + "/root/");
-	    makeDir(plotDir + "/C/");
-	    //
-	    // Save Canvas
-	    const std::string& grName = v.second.at("Err_Stat").GetName();
-	    const auto& name = grName.substr(0, grName.rfind("_Err_Stat"));
-	    c.SaveAs((plotDir + "/png/"  + name + ".png" ).c_str());
-	    c.SaveAs((plotDir + "/pdf/"  + name + ".pdf" ).c_str());
-	    c.SaveAs((plotDir + "/root/" + name + ".root").c_str());
-	    //c.SaveAs((plotDir + "/C/"    + name + ".C"   ).c_str());
-	    //
-	    // Clean up memory
-	    c.Clear(); c.Close();
-	  }
+	  });
 	}
       }
     }
   }
+  //
+  // Render the graphs
+  drawPlotJobs(jobs, nCores);
 };
 
 
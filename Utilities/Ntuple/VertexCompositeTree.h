@@ -9,6 +9,8 @@
 #include <TSystem.h>
 #include <TFile.h>
 #include <TVector3.h>
+#include <TEnv.h>
+#include <TTreeCache.h>
 
 // Header file for c++ classes
 #include <iostream>
@@ -28,6 +30,13 @@ class VertexCompositeTree {
 
 public :
 
+  static const Long64_t CACHESIZE = 100*1024*1024;
+
+  // MUON ID FLAVOURS
+  enum MuonIDKind { kTight=0, kHybrid, kSoft };
+  enum MuonIDType { kDefault=0, kY15, kPOG, kY18, kNMuonIDType };
+  static MuonIDType MuonIDTypeOf (const std::string& type) { return (type=="Y15" ? kY15 : (type=="POG" ? kPOG : (type=="Y18" ? kY18 : (type=="" ? kDefault : kNMuonIDType)))); }
+
   VertexCompositeTree();
   virtual ~VertexCompositeTree();
   virtual Bool_t       GetTree         (const std::vector< std::string >&, const std::string& treeName="dimucontana");
@@ -37,6 +46,10 @@ public :
   virtual Long64_t     GetTreeEntries  (void) const { return ((fChain_ && fChain_->GetTree()) ? fChain_->GetTree()->GetEntriesFast() : -1); }
   virtual Int_t        GetTreeNumber   (void) const { return fCurrent_; }
   virtual void         Clear           (void);
+  virtual void         SetFileCache    (const std::string& cacheDir, const std::vector< std::string >& mirrors={}, const std::string& remote="root://cms-xrd-global.cern.ch/");
+  virtual Bool_t       ResolveFiles    (std::vector< std::string >&) const;
+  virtual void         SetReadProfile  (const std::vector< std::string >& branches, const Long64_t& cacheSize=Long64_t(CACHESIZE), const Bool_t& prefetch=true);
+  virtual void         PrintReadStats  (void);
   static  void         GenerateDictionaries (void);
 
   // EVENT INFO GETTERS
@@ -217,18 +230,26 @@ public :
   Float_t*  dZ_mu()                       { SetBranch("dZ_mu");                       return dZ_mu_;                      }
 
   // EXTRA GETTERS
-  Bool_t    tightMuon1  (const UInt_t& iC, const std::string& type="");
-  Bool_t    tightMuon2  (const UInt_t& iC, const std::string& type="");
-  Bool_t    hybridMuon1 (const UInt_t& iC, const std::string& type="");
-  Bool_t    hybridMuon2 (const UInt_t& iC, const std::string& type="");
-  Bool_t    softMuon1   (const UInt_t& iC, const std::string& type="");
-  Bool_t    softMuon2   (const UInt_t& iC, const std::string& type="");
-  Bool_t    tightCand   (const UInt_t& iC, const std::string& type="") { return (tightMuon1(iC, type) && tightMuon2(iC, type));   }
-  Bool_t    hybridCand  (const UInt_t& iC, const std::string& type="") { return (hybridMuon1(iC, type) && hybridMuon2(iC, type)); }
-  Bool_t    softCand    (const UInt_t& iC, const std::string& type="") { return (softMuon1(iC, type) && softMuon2(iC, type));     }
+  Bool_t    muonID1     (const UInt_t& iC, const MuonIDKind& kind, const MuonIDType& type=kDefault) { return (MuonIDBits(kind, type, 1)[iC] & MuonIDBit(kind, type)); }
+  Bool_t    muonID2     (const UInt_t& iC, const MuonIDKind& kind, const MuonIDType& type=kDefault) { return (MuonIDBits(kind, type, 2)[iC] & MuonIDBit(kind, type)); }
+  Bool_t    tightMuon1  (const UInt_t& iC, const MuonIDType& type=kDefault) { return muonID1(iC, kTight, type);  }
+  Bool_t    tightMuon2  (const UInt_t& iC, const MuonIDType& type=kDefault) { return muonID2(iC, kTight, type);  }
+  Bool_t    hybridMuon1 (const UInt_t& iC, const MuonIDType& type=kDefault) { return muonID1(iC, kHybrid, type); }
+  Bool_t    hybridMuon2 (const UInt_t& iC, const MuonIDType& type=kDefault) { return muonID2(iC, kHybrid, type); }
+  Bool_t    softMuon1   (const UInt_t& iC, const MuonIDType& type=kDefault) { return muonID1(iC, kSoft, type);   }
+  Bool_t    softMuon2   (const UInt_t& iC, const MuonIDType& type=kDefault) { return muonID2(iC, kSoft, type);   }
+  Bool_t    tightMuon1  (const UInt_t& iC, const std::string& type) { return tightMuon1(iC, MuonIDTypeOf(type));  }
+  Bool_t    tightMuon2  (const UInt_t& iC, const std::string& type) { return tightMuon2(iC, MuonIDTypeOf(type));  }
+  Bool_t    hybridMuon1 (const UInt_t& iC, const std::string& type) { return hybridMuon1(iC, MuonIDTypeOf(type)); }
+  Bool_t    hybridMuon2 (const UInt_t& iC, const std::string& type) { return hybridMuon2(iC, MuonIDTypeOf(type)); }
+  Bool_t    softMuon1   (const UInt_t& iC, const std::string& type) { return softMuon1(iC, MuonIDTypeOf(type));   }
+  Bool_t    softMuon2   (const UInt_t& iC, const std::string& type) { return softMuon2(iC, MuonIDTypeOf(type));   }
+  Bool_t    tightCand   (const UInt_t& iC, const MuonIDType& type=kDefault) { return (tightMuon1(iC, type) && tightMuon2(iC, type));   }
+  Bool_t    hybridCand  (const UInt_t& iC, const MuonIDType& type=kDefault) { return (hybridMuon1(iC, type) && hybridMuon2(iC, type)); }
+  Bool_t    softCand    (const UInt_t& iC, const MuonIDType& type=kDefault) { return (softMuon1(iC, type) && softMuon2(iC, type));     }
   Bool_t    trigCand    (const UInt_t& iT, const UInt_t& iC, const bool& OR=false) { if (trigMuon1().size()<=iT) { throw std::runtime_error(Form("[ERROR] Trigger index1: %d > %lu", iT, trigMuon1().size())); }; return (OR ? (trigMuon1()[iT][iC] || trigMuon2()[iT][iC]) : (trigMuon1()[iT][iC] && trigMuon2()[iT][iC])); }
   Double_t  phiAsym     (const UInt_t& iC);
-  Int_t     GenIdx      (const Short_t& iC) { for (uint iGen=0; iGen<candSize_gen(); iGen++) { if (iC==RecIdx_gen()[iGen]) { return iGen; } }; return -1; }
+  Int_t     GenIdx      (const Short_t& iC) { if (genIdxEntry_!=entry_) { BuildGenIdx(); }; return ((iC>=0 && UInt_t(iC)<NCAND) ? genIdx_[iC] : -1); }
 
 
  private:
@@ -238,6 +259,15 @@ public :
   virtual void      SetBranch       (const std::string&);
   virtual void      InitTree        (void);
   virtual Int_t     LoadEntry       (void) { return fChain_->GetEntry(entry_); }
+  virtual void      BuildGenIdx     (void);
+  virtual void      FillMuonID      (const MuonIDKind&, const MuonIDType&);
+  UShort_t          MuonIDBit       (const MuonIDKind& kind, const MuonIDType& type) const { return (1 << (kind*(kNMuonIDType+1) + type)); }
+  const UShort_t*   MuonIDBits      (const MuonIDKind& kind, const MuonIDType& type, const UShort_t& dau)
+  {
+    if (muonIDEntry_!=entry_) { muonIDDone_ = 0; muonIDEntry_ = entry_; }
+    if (!(muonIDDone_ & MuonIDBit(kind, type))) { FillMuonID(kind, type); }
+    return (dau==1 ? muonIDBits1_ : muonIDBits2_);
+  }
 
   template <typename T> T GET(T* x) { return ( (x) ? *x : T() ); }
   
@@ -248,6 +278,40 @@ public :
   
   std::unordered_map<std::string, bool> activeBranches_;
 
+  // FILE RESOLUTION (logical /store/ names -> local mirror, local cache or remote URL)
+  Bool_t                     useFileCache_=false;
+  std::string                fileCacheDir_="";
+  std::vector< std::string > fileMirrors_;
+  std::string                fileRemote_="root://cms-xrd-global.cern.ch/";
+  static const Int_t         READAHEAD = 8*1024*1024;
+
+  // READ PROFILE (branches declared before the event loop, and read statistics)
+  std::vector< std::string > readBranches_;
+  Bool_t                     readProfile_=false;
+  Long64_t                   readCacheSize_=CACHESIZE;
+  Bool_t                     readPrefetch_=false;
+  // Number of trees using prefetching, and TFile.AsyncPrefetching before the first one, restored after the last one
+  static Int_t&              PrefetchUsers   (void) { static Int_t n = 0; return n; }
+  static Int_t&              PrefetchSaved   (void) { static Int_t v = 0; return v; }
+  static const Int_t         READLEARN = 10;
+  virtual void               ApplyReadProfile(void);
+  Long64_t                   readBytes0_=0;
+  Int_t                      readCalls0_=0;
+  Long64_t                   readMiss_=0;
+  virtual void               AddReadMiss     (void);
+
+  // MUON ID DECISIONS (one bit per ID kind and type, filled once per entry when first requested)
+  UShort_t  muonIDBits1_[NCAND]={0};
+  UShort_t  muonIDBits2_[NCAND]={0};
+  UShort_t  muonIDDone_=0;
+  Long64_t  muonIDEntry_=-1;
+
+  // GEN MATCHING INDEX (reco candidate -> gen candidate, filled once per entry)
+  Short_t   genIdx_[NCAND];
+  Short_t   genIdxRec_[NGEN];
+  UInt_t    genIdxSize_=0;
+  Long64_t  genIdxEntry_=-1;
+
   static const UInt_t NEP   = 3;
   static const UInt_t NTRG  = 15;
   static const UInt_t NSEL  = 10;
@@ -435,10 +499,13 @@ public :
 
 VertexCompositeTree::VertexCompositeTree() : fChain_(0)
 {
+  std::fill_n(genIdx_, NCAND, -1);
 };
 
 VertexCompositeTree::~VertexCompositeTree()
 {
+  if (readProfile_) { PrintReadStats(); }
+  if (readPrefetch_ && --PrefetchUsers()==0) { gEnv->SetValue("TFile.AsyncPrefetching", PrefetchSaved()); }
   if (fChain_) { const auto& f = fChain_->GetCurrentFile(); if (f) { f->Close(); delete f; }; fChain_->Reset(); }
   for (auto& c : fChainM_) { if (c.second) { c.second->Reset(); } }
 };
@@ -453,7 +520,7 @@ Bool_t VertexCompositeTree::GetTree(const std::vector< std::string >& inFileName
 {
   // Check the File Names
   auto fileName = inFileName;
-  for (auto& f : fileName) { if (f.rfind("/store/", 0)==0) { f = "root://cms-xrd-global.cern.ch/" + f; } }
+  if (!ResolveFiles(fileName)) return false;
   // Open the input files
   const auto& f = TFile::Open(fileName[0].c_str(), "READ");
   if (!f || !f->IsOpen() || f->IsZombie()) { std::cout << "[ERROR] Failed to open file: " << fileName[0] << std::endl; return false; }
@@ -485,10 +552,125 @@ Bool_t VertexCompositeTree::GetTree(const std::vector< std::string >& inFileName
   if (!fChain_) return false;
   // Set All Branches to Status 0
   fChain_->SetBranchStatus("*",0);
+  // Tune the reading of local replicas, only if the file cache was requested
+  if (useFileCache_ && fileName[0].rfind("root://", 0)!=0) {
+    TFile::SetReadaheadSize(READAHEAD);
+    fChain_->SetCacheSize(CACHESIZE);
+  }
+  // Configure the TTreeCache from the declared read profile
+  if (readProfile_) { ApplyReadProfile(); }
   //
   return true;
 };
 
+void VertexCompositeTree::SetFileCache(const std::string& cacheDir, const std::vector< std::string >& mirrors, const std::string& remote)
+{
+  // Logical file names (/store/...) are searched in the mirrors, then in the cache directory, and otherwise
+  // copied from the remote source into the cache directory (or read remotely if no cache directory is set)
+  // Local replicas are then read with a larger TTreeCache and the process-wide TFile readahead
+  useFileCache_ = true;
+  fileCacheDir_ = cacheDir;
+  if (fileCacheDir_!="" && fileCacheDir_.back()=='/') { fileCacheDir_.pop_back(); }
+  fileMirrors_ = mirrors;
+  for (auto& m : fileMirrors_) { if (m!="" && m.back()=='/') { m.pop_back(); } }
+  fileRemote_ = remote;
+};
+
+Bool_t VertexCompositeTree::ResolveFiles(std::vector< std::string >& fileName) const
+{
+  if (fileName.empty()) { std::cout << "[ERROR] No input files were provided!" << std::endl; return false; }
+  // Without a file cache, logical file names are read from the remote source
+  if (!useFileCache_) {
+    for (auto& f : fileName) { if (f.rfind("/store/", 0)==0) { f = fileRemote_ + f; } }
+    return true;
+  }
+  std::vector< std::string > missing;
+  for (auto& f : fileName) {
+    if (f.rfind("/store/", 0)==0) {
+      bool found = false;
+      // Look for a local mirror
+      for (const auto& m : fileMirrors_) {
+        if (!gSystem->AccessPathName((m+f).c_str())) { f = m+f; found = true; break; }
+      }
+      if (found) continue;
+      // Look for a local replica in the cache, or copy the file into it
+      if (fileCacheDir_!="") {
+        const auto& local = fileCacheDir_+f;
+        if (gSystem->AccessPathName(local.c_str())) {
+          std::cout << "[INFO] Copying " << f << " into the file cache: " << fileCacheDir_ << std::endl;
+          gSystem->mkdir(local.substr(0, local.rfind("/")).c_str(), kTRUE);
+          const auto& tmp = local + Form(".%d.tmp", gSystem->GetPid());
+          if (!TFile::Cp((fileRemote_+f).c_str(), tmp.c_str(), kFALSE) || gSystem->Rename(tmp.c_str(), local.c_str())!=0) {
+            gSystem->Unlink(tmp.c_str()); missing.push_back(f); f = fileRemote_ + f; continue;
+          }
+        }
+        f = local;
+      }
+      else { f = fileRemote_ + f; }
+    }
+    else if (f.find("://")==std::string::npos && gSystem->AccessPathName(f.c_str())) { missing.push_back(f); }
+  }
+  // Report all the files that could not be found locally, they are still added to the chain as before
+  if (!missing.empty()) {
+    std::cout << "[WARNING] The following " << missing.size() << " input files were not found locally:" << std::endl;
+    for (const auto& f : missing) { std::cout << "  " << f << std::endl; }
+  }
+  return true;
+};
+
+void VertexCompositeTree::SetReadProfile(const std::vector< std::string >& branches, const Long64_t& cacheSize, const Bool_t& prefetch)
+{
+  // Declare the branches read in the event loop. Call it before GetTree, so that the input files are opened with prefetching
+  readBranches_ = branches;
+  readCacheSize_ = cacheSize;
+  readProfile_ = true;
+  if (prefetch && !readPrefetch_) {
+    if (fChain_) { std::cout << "[WARNING] SetReadProfile: Prefetching only applies to the files opened from now on!" << std::endl; }
+    if (PrefetchUsers()++==0) { PrefetchSaved() = gEnv->GetValue("TFile.AsyncPrefetching", 0); }
+    gEnv->SetValue("TFile.AsyncPrefetching", 1);
+    readPrefetch_ = true;
+  }
+  std::cout << "[INFO] Read profile: " << readBranches_.size() << " branches, cache size " << readCacheSize_/(1024*1024) << " MB, prefetching " << (prefetch ? "enabled" : "disabled") << std::endl;
+  if (fChain_) { ApplyReadProfile(); }
+};
+
+void VertexCompositeTree::ApplyReadProfile(void)
+{
+  // Activate the declared branches and add them to the TTreeCache before the event loop starts
+  // The cache keeps learning during the first entries, to include the branches activated by the composite getters
+  fChain_->SetCacheSize(readCacheSize_);
+  fChain_->SetCacheLearnEntries(READLEARN);
+  for (const auto& n : readBranches_) {
+    if (!fChain_->GetBranch(n.c_str())) { std::cout << "[WARNING] SetReadProfile: Branch " << n << " was not found!" << std::endl; continue; }
+    fChain_->SetBranchStatus(n.c_str(), 1);
+    activeBranches_[n] = true;
+    fChain_->AddBranchToCache(n.c_str(), kTRUE);
+  }
+  // Reset the read statistics
+  readBytes0_ = TFile::GetFileBytesRead();
+  readCalls0_ = TFile::GetFileReadCalls();
+  readMiss_ = 0;
+};
+
+void VertexCompositeTree::AddReadMiss(void)
+{
+  const auto& f = fChain_->GetCurrentFile();
+  if (!f || !fChain_->GetTree()) return;
+  const auto& tc = dynamic_cast<TTreeCache*>(f->GetCacheRead(fChain_->GetTree()));
+  if (tc) { readMiss_ += tc->GetNoCacheReadCalls(); }
+};
+
+void VertexCompositeTree::PrintReadStats(void)
+{
+  if (!fChain_) return;
+  AddReadMiss();
+  std::cout << "[INFO] Read statistics of " << fChain_->GetName() << ": "
+            << (TFile::GetFileBytesRead()-readBytes0_)/(1024.*1024.) << " MB read in "
+            << (TFile::GetFileReadCalls()-readCalls0_) << " read calls, with "
+            << readMiss_ << " reads not served by the TTreeCache" << std::endl;
+  readMiss_ = 0;
+};
+
 Int_t VertexCompositeTree::GetEntry(Long64_t entry)
 {
   // Read contents of entry.
@@ -506,6 +688,8 @@ Long64_t VertexCompositeTree::LoadTree(Long64_t entry)
 {
   // Set the environment to read one entry
   if (!fChain_) return -5;
+  // Collect the cache misses of the current file before moving to the next one
+  if (readProfile_ && fChain_->GetTree() && (entry < fChain_->GetChainOffset() || entry >= fChain_->GetChainOffset() + fChain_->GetTree()->GetEntries())) { AddReadMiss(); }
   const auto& centry = fChain_->LoadTree(entry);
   if (fChain_->GetTreeNumber() != fCurrent_) { fCurrent_ = fChain_->GetTreeNumber(); }
   return centry;
@@ -893,100 +1077,80 @@ void VertexCompositeTree::GenerateDictionaries(void)
   gSystem->ChangeDirectory(CWD.c_str());
 };
 
-Bool_t VertexCompositeTree::tightMuon1(const UInt_t& iC, const std::string& type)
-{
-  if      (type==""   ) { return tightMuon1()[iC]; } 
-  else if (type=="Y15") {
-    return ( GlbMuon1()[iC] && (GlbTrkChiD1()[iC] < 10.) &&
-             (nMuonHitD1()[iC] > 0) && (nMatchedStationD1()[iC] > 1) &&
-             (nPixelHitD1()[iC] > 0) && (nTrackerLayerD1()[iC] > 5) &&
-             (fabs(muondXYD1()[iC]) < 0.2) && (fabs(muondZD1()[iC]) < 0.5) );
-  }
-  else if (type=="POG") {
-    return ( GlbMuon1()[iC] && PFMuon1()[iC] && (GlbTrkChiD1()[iC] < 10.) &&
-             (nMuonHitD1()[iC] > 0) && (nMatchedStationD1()[iC] > 1) &&
-             (nPixelHitD1()[iC] > 0) && (nTrackerLayerD1()[iC] > 5) &&
-             (fabs(muondXYD1()[iC]) < 0.2) && (fabs(muondZD1()[iC]) < 0.5) );
-  }
-  else { std::cout << "[ERROR] Tight MuonID is not defined for " << type << std::endl; }
-  return false;
-};
-
-Bool_t VertexCompositeTree::tightMuon2(const UInt_t& iC, const std::string& type)
-{
-  if      (type==""   ) { return tightMuon2()[iC]; }
-  else if (type=="Y15") {
-    return ( GlbMuon2()[iC] && (GlbTrkChiD2()[iC] < 10.) &&
-             (nMuonHitD2()[iC] > 0) && (nMatchedStationD2()[iC] > 1) &&
-             (nPixelHitD2()[iC] > 0) && (nTrackerLayerD2()[iC] > 5) &&
-             (fabs(muondXYD2()[iC]) < 0.2) && (fabs(muondZD2()[iC]) < 0.5) );
-  }
-  else if (type=="POG") {
-    return ( GlbMuon2()[iC] && PFMuon2()[iC] && (GlbTrkChiD2()[iC] < 10.) &&
-             (nMuonHitD2()[iC] > 0) && (nMatchedStationD2()[iC] > 1) &&
-             (nPixelHitD2()[iC] > 0) && (nTrackerLayerD2()[iC] > 5) &&
-             (fabs(muondXYD2()[iC]) < 0.2) && (fabs(muondZD2()[iC]) < 0.5) );
-  }
-  else { std::cout << "[ERROR] Tight MuonID is not defined for " << type << std::endl; }
-  return false;
-};
-
-Bool_t VertexCompositeTree::hybridMuon1(const UInt_t& iC, const std::string& type)
-{
-  if      (type==""   ) { return (hybridMuon1()[iC] && trkMuon1()[iC]); }
-  else if (type=="Y15") {
-    return ( GlbMuon1()[iC] && OneStMuon1()[iC] &&
-             (nPixelLayerD1()[iC] > 0) && (nTrackerLayerD1()[iC] > 5) &&
-             (fabs(dXYD1()[iC]) < 0.3) && (fabs(dZD1()[iC]) < 20.) );
-  }
-  else if (type=="Y18") {
-    return ( GlbMuon1()[iC] && trkMuon1()[iC] &&
-             (nPixelLayerD1()[iC] > 0) && (nTrackerLayerD1()[iC] > 5) &&
-             (fabs(dXYD1()[iC]) < 0.3) && (fabs(dZD1()[iC]) < 20.) );
-  }
-  else { std::cout << "[ERROR] Hybrid MuonID is not defined for " << type << std::endl; }
-  return false;
-};
-
-Bool_t VertexCompositeTree::hybridMuon2(const UInt_t& iC, const std::string& type)
+void VertexCompositeTree::FillMuonID(const MuonIDKind& kind, const MuonIDType& type)
 {
-  if      (type==""   ) { return (hybridMuon2()[iC] && trkMuon2()[iC]); }
-  else if (type=="Y15") {
-    return ( GlbMuon2()[iC] && OneStMuon2()[iC] &&
-             (nPixelLayerD2()[iC] > 0) && (nTrackerLayerD2()[iC] > 5) &&
-             (fabs(dXYD2()[iC]) < 0.3) && (fabs(dZD2()[iC]) < 20.) );
-  }
-  else if (type=="Y18") {
-    return ( GlbMuon2()[iC] && trkMuon2()[iC] &&
-             (nPixelLayerD2()[iC] > 0) && (nTrackerLayerD2()[iC] > 5) &&
-             (fabs(dXYD2()[iC]) < 0.3) && (fabs(dZD2()[iC]) < 20.) );
-  }
-  else { std::cout << "[ERROR] Hybrid MuonID is not defined for " << type << std::endl; }
-  return false;
-};
-
-Bool_t VertexCompositeTree::softMuon1(const UInt_t& iC, const std::string& type)
-{
-  if      (type==""   ) { return softMuon1()[iC]; }
-  else if (type=="POG") {
-    return ( OneStMuon1()[iC] && HPMuon1()[iC] &&
-             (nPixelLayerD1()[iC] > 0) && (nTrackerLayerD1()[iC] > 5) &&
-             (fabs(dXYD1()[iC]) < 0.3) && (fabs(dZD1()[iC]) < 20.) );
+  const auto& bit = MuonIDBit(kind, type);
+  const auto& nCand = std::min(candSize(), NCAND);
+  for (const auto& dau : {1, 2}) {
+    const auto& isD1 = (dau==1);
+    auto bits = (isD1 ? muonIDBits1_ : muonIDBits2_);
+    auto setBit = [&](const UInt_t& iC, const bool& pass) { if (pass) { bits[iC] |= bit; } else { bits[iC] &= ~bit; } };
+    if (kind==kTight && type==kDefault) {
+      const auto& tightMuon = (isD1 ? tightMuon1() : tightMuon2());
+      for (UInt_t iC=0; iC<nCand; iC++) { setBit(iC, tightMuon[iC]); }
+    }
+    else if (kind==kTight && (type==kY15 || type==kPOG)) {
+      const auto& GlbMuon = (isD1 ? GlbMuon1() : GlbMuon2());
+      const auto& PFMuon = (type==kPOG ? (isD1 ? PFMuon1() : PFMuon2()) : NULL);
+      const auto& GlbTrkChi = (isD1 ? GlbTrkChiD1() : GlbTrkChiD2());
+      const auto& nMuonHit = (isD1 ? nMuonHitD1() : nMuonHitD2());
+      const auto& nMatchedStation = (isD1 ? nMatchedStationD1() : nMatchedStationD2());
+      const auto& nPixelHit = (isD1 ? nPixelHitD1() : nPixelHitD2());
+      const auto& nTrackerLayer = (isD1 ? nTrackerLayerD1() : nTrackerLayerD2());
+      const auto& muondXY = (isD1 ? muondXYD1() : muondXYD2());
+      const auto& muondZ = (isD1 ? muondZD1() : muondZD2());
+      for (UInt_t iC=0; iC<nCand; iC++) {
+        setBit(iC, ( GlbMuon[iC] && (!PFMuon || PFMuon[iC]) && (GlbTrkChi[iC] < 10.) &&
+                     (nMuonHit[iC] > 0) && (nMatchedStation[iC] > 1) &&
+                     (nPixelHit[iC] > 0) && (nTrackerLayer[iC] > 5) &&
+                     (fabs(muondXY[iC]) < 0.2) && (fabs(muondZ[iC]) < 0.5) ));
+      }
+    }
+    else if (kind==kHybrid && type==kDefault) {
+      const auto& hybridMuon = (isD1 ? hybridMuon1() : hybridMuon2());
+      const auto& trkMuon = (isD1 ? trkMuon1() : trkMuon2());
+      for (UInt_t iC=0; iC<nCand; iC++) { setBit(iC, (hybridMuon[iC] && trkMuon[iC])); }
+    }
+    else if ((kind==kHybrid && (type==kY15 || type==kY18)) || (kind==kSoft && type==kPOG)) {
+      const auto& GlbMuon = (kind==kHybrid ? (isD1 ? GlbMuon1() : GlbMuon2()) : NULL);
+      const auto& OneStMuon = (type!=kY18 ? (isD1 ? OneStMuon1() : OneStMuon2()) : NULL);
+      const auto& trkMuon = (type==kY18 ? (isD1 ? trkMuon1() : trkMuon2()) : NULL);
+      const auto& HPMuon = (kind==kSoft ? (isD1 ? HPMuon1() : HPMuon2()) : NULL);
+      const auto& nPixelLayer = (isD1 ? nPixelLayerD1() : nPixelLayerD2());
+      const auto& nTrackerLayer = (isD1 ? nTrackerLayerD1() : nTrackerLayerD2());
+      const auto& dXY = (isD1 ? dXYD1() : dXYD2());
+      const auto& dZ = (isD1 ? dZD1() : dZD2());
+      for (UInt_t iC=0; iC<nCand; iC++) {
+        setBit(iC, ( (!GlbMuon || GlbMuon[iC]) && (!OneStMuon || OneStMuon[iC]) && (!trkMuon || trkMuon[iC]) && (!HPMuon || HPMuon[iC]) &&
+                     (nPixelLayer[iC] > 0) && (nTrackerLayer[iC] > 5) &&
+                     (fabs(dXY[iC]) < 0.3) && (fabs(dZ[iC]) < 20.) ));
+      }
+    }
+    else if (kind==kSoft && type==kDefault) {
+      const auto& softMuon = (isD1 ? softMuon1() : softMuon2());
+      for (UInt_t iC=0; iC<nCand; iC++) { setBit(iC, softMuon[iC]); }
+    }
+    else {
+      if (isD1) { std::cout << "[ERROR] " << (kind==kTight ? "Tight" : (kind==kHybrid ? "Hybrid" : "Soft")) << " MuonID is not defined for type " << type << std::endl; }
+      for (UInt_t iC=0; iC<nCand; iC++) { setBit(iC, false); }
+    }
   }
-  else { std::cout << "[ERROR] Soft MuonID is not defined for " << type << std::endl; }
-  return false;
+  muonIDDone_ |= bit;
 };
 
-Bool_t VertexCompositeTree::softMuon2(const UInt_t& iC, const std::string& type)
+void VertexCompositeTree::BuildGenIdx(void)
 {
-  if      (type==""   ) { return softMuon2()[iC]; }
-  else if (type=="POG") {
-    return ( OneStMuon2()[iC] && HPMuon2()[iC] &&
-             (nPixelLayerD2()[iC] > 0) && (nTrackerLayerD2()[iC] > 5) &&
-             (fabs(dXYD2()[iC]) < 0.3) && (fabs(dZD2()[iC]) < 20.) );
+  // Reset the reco candidates matched in the previous entry
+  for (UInt_t i=0; i<genIdxSize_; i++) { genIdx_[genIdxRec_[i]] = -1; }
+  genIdxSize_ = 0;
+  // Associate each reco candidate to its first matched gen candidate
+  const auto& nGen = candSize_gen();
+  const auto& recIdx = RecIdx_gen();
+  for (UInt_t iGen=0; iGen<nGen && iGen<NGEN; iGen++) {
+    const auto& iC = recIdx[iGen];
+    if (iC>=0 && UInt_t(iC)<NCAND && genIdx_[iC]<0) { genIdx_[iC] = iGen; genIdxRec_[genIdxSize_++] = iC; }
   }
-  else { std::cout << "[ERROR] Soft MuonID is not defined for " << type << std::endl; }
-  return false;
+  genIdxEntry_ = entry_;
 };
 
 Double_t VertexCompositeTree::phiAsym(const UInt_t& iC)
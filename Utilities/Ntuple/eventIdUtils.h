@@ -0,0 +1,204 @@
+#ifndef eventIdUtils_h
+#define eventIdUtils_h
+
+#include "TTree.h"
+#include "TBranch.h"
+#include "TDirectory.h"
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include <iostream>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <tuple>
+#include <algorithm>
+#include <cstdint>
+
+
+typedef std::tuple<uint, uint, uint> EvtTuple;
+typedef std::set<EvtTuple> EvtTupleSet;
+
+
+bool findDuplicates(TTree& tree, EvtTupleSet& dupSet, std::map<int, std::set<int>>& lumiMap, const Long64_t& maxKeys=200000000, const uint& nThreads=4);
+Long64_t copyUniqueEvents(TTree& tree, TTree& tnew, const EvtTupleSet& dupSet);
+bool fillLumiMap(TTree& tree, std::map<int, std::set<int>>& lumiMap);
+bool saveLumiMap(const std::map<int, std::set<int>>& lumiMap, TDirectory& dir);
+bool loadLumiMap(std::map<int, std::set<int>>& lumiMap, TDirectory& dir);
+
+
+bool findDuplicates(TTree& tree, EvtTupleSet& dupSet, std::map<int, std::set<int>>& lumiMap, const Long64_t& maxKeys, const uint& nThreads)
+{
+  // Events are identified by a run number and a 64-bit (LSNb, EventNb) key
+  // The lumi sections are split in partitions of at most maxKeys events (8 bytes each), processed one at a time
+  dupSet.clear();
+  lumiMap.clear();
+  uint RunNb, LSNb, EventNb;
+  tree.SetBranchStatus("*",0);
+  tree.SetBranchStatus("RunNb",1);
+  tree.SetBranchStatus("LSNb",1);
+  tree.SetBranchStatus("EventNb",1);
+  tree.SetBranchAddress("RunNb",&RunNb);
+  tree.SetBranchAddress("LSNb",&LSNb);
+  tree.SetBranchAddress("EventNb",&EventNb);
+  const auto& bRun = tree.GetBranch("RunNb");
+  const auto& bLS = tree.GetBranch("LSNb");
+  const auto& bEvt = tree.GetBranch("EventNb");
+  if (!bRun || !bLS || !bEvt) { std::cout << "[ERROR] Event identity branches not found in " << tree.GetName() << std::endl; tree.SetBranchStatus("*",1); tree.ResetBranchAddresses(); return false; }
+
+  // Count the events of each lumi section and build the luminosity map
+  const auto& nentries = tree.GetEntries();
+  std::map<uint, std::map<uint, Long64_t>> lsSize;
+  for (Long64_t i=0; i<nentries; i++) {
+    if (i%10000000==0) { std::cout << "Done: " << i << " / " << nentries << " (" << i*100./nentries << "%)" << std::endl; }
+    bRun->GetEntry(i); bLS->GetEntry(i);
+    lsSize[RunNb][LSNb]++;
+  }
+  for (const auto& r : lsSize) { for (const auto& l : r.second) { lumiMap[r.first].insert(l.first); } }
+
+  // Group the lumi sections in partitions, a run larger than maxKeys is split between several partitions
+  // Duplicated events always share the same run and lumi section, so each partition can be checked alone
+  std::map<uint, std::map<uint, uint>> lsPart;
+  std::vector<std::map<uint, Long64_t>> partitions(1);
+  Long64_t size = 0;
+  for (const auto& r : lsSize) {
+    for (const auto& l : r.second) {
+      if (size>0 && size+l.second>maxKeys) { partitions.push_back({}); size = 0; }
+      if (l.second>maxKeys) { std::cout << "[WARNING] Lumi section " << l.first << " of run " << r.first << " has " << l.second << " events, more than " << maxKeys << " keys per partition" << std::endl; }
+      lsPart[r.first][l.first] = partitions.size()-1;
+      partitions.back()[r.first] += l.second;
+      size += l.second;
+    }
+  }
+  lsSize.clear();
+  if (partitions.size()>1) { std::cout << "[INFO] Checking duplicates of " << tree.GetName() << " in " << partitions.size() << " partitions" << std::endl; }
+
+  ROOT::TThreadExecutor pool(std::max(nThreads, 1u));
+  for (uint p=0; p<partitions.size(); p++) {
+    // Collect the keys of the lumi sections in this partition, grouped by run
+    std::unordered_map<uint, uint> runIdx;
+    std::vector<uint> runs;
+    std::vector<std::vector<uint64_t>> keys;
+    for (const auto& r : partitions[p]) {
+      runIdx[r.first] = runs.size();
+      runs.push_back(r.first);
+      keys.push_back({});
+      keys.back().reserve(r.second);
+    }
+    uint lastRun = 0, lastLS = 0, lastPart = 0;
+    bool first = true;
+    for (Long64_t i=0; i<nentries; i++) {
+      bRun->GetEntry(i); bLS->GetEntry(i);
+      if (first || RunNb!=lastRun || LSNb!=lastLS) {
+        lastPart = lsPart.at(RunNb).at(LSNb); lastRun = RunNb; lastLS = LSNb; first = false;
+      }
+      if (lastPart!=p) continue;
+      bEvt->GetEntry(i);
+      keys[runIdx.at(RunNb)].push_back((uint64_t(LSNb)<<32) | uint64_t(EventNb));
+    }
+    // Sort the keys of each run in parallel and find the repeated ones
+    std::vector<std::vector<uint64_t>> dupKeys(runs.size());
+    pool.Foreach([&](const uint& j)
+    {
+      auto& k = keys[j];
+      std::sort(k.begin(), k.end());
+      for (size_t n=1; n<k.size(); n++) { if (k[n]==k[n-1] && (dupKeys[j].empty() || dupKeys[j].back()!=k[n])) { dupKeys[j].push_back(k[n]); } }
+      std::vector<uint64_t>().swap(k);
+    }, ROOT::TSeqU(runs.size()));
+    for (uint j=0; j<runs.size(); j++) {
+      for (const auto& k : dupKeys[j]) { dupSet.insert(EvtTuple(runs[j], uint(k>>32), uint(k & 0xFFFFFFFF))); }
+    }
+  }
+  for (const auto& d : dupSet) { std::cout << "Found duplicate in: " << std::get<0>(d) << " , " << std::get<1>(d) << " , " << std::get<2>(d) << std::endl; }
+
+  tree.ResetBranchAddresses();
+  tree.SetBranchStatus("*",1);
+  return true;
+};
+
+
+Long64_t copyUniqueEvents(TTree& tree, TTree& tnew, const EvtTupleSet& dupSet)
+{
+  // Copy all events, keeping only the first occurrence of the duplicated ones
+  uint RunNb, LSNb, EventNb;
+  tree.SetBranchAddress("RunNb",&RunNb);
+  tree.SetBranchAddress("LSNb",&LSNb);
+  tree.SetBranchAddress("EventNb",&EventNb);
+  // Make the output tree read the event identity from the same buffers
+  tree.CopyAddresses(&tnew);
+  EvtTupleSet copied;
+  const auto& nentries = tree.GetEntries();
+  Long64_t nDup = 0;
+  for (Long64_t i=0; i<nentries; i++) {
+    if (i%1000000==0) { std::cout << "Done: " << i << " / " << nentries << " (" << i*100./nentries << "%)" << std::endl; }
+    tree.GetEntry(i);
+    if (!dupSet.empty()) {
+      const EvtTuple evtTuple(RunNb, LSNb, EventNb);
+      if (dupSet.find(evtTuple)!=dupSet.end() && !copied.insert(evtTuple).second) { nDup++; continue; }
+    }
+    tnew.Fill();
+  }
+  tree.CopyAddresses(&tnew, kTRUE);
+  tree.ResetBranchAddresses();
+  return nDup;
+};
+
+
+bool fillLumiMap(TTree& tree, std::map<int, std::set<int>>& lumiMap)
+{
+  // Only read the run and lumi-section branches
+  lumiMap.clear();
+  uint RunNb, LSNb;
+  tree.SetBranchStatus("*",0);
+  tree.SetBranchStatus("RunNb",1);
+  tree.SetBranchStatus("LSNb",1);
+  tree.SetBranchAddress("RunNb",&RunNb);
+  tree.SetBranchAddress("LSNb",&LSNb);
+  const auto& bRun = tree.GetBranch("RunNb");
+  const auto& bLS = tree.GetBranch("LSNb");
+  if (!bRun || !bLS) { std::cout << "[ERROR] Luminosity branches not found in " << tree.GetName() << std::endl; tree.SetBranchStatus("*",1); return false; }
+  const auto& nentries = tree.GetEntries();
+  for (Long64_t i=0; i<nentries; i++) {
+    if (i%1000000==0) { std::cout << "Done: " << i << " / " << nentries << " (" << i*100./nentries << "%)" << std::endl; }
+    bRun->GetEntry(i); bLS->GetEntry(i);
+    lumiMap[RunNb].insert(LSNb);
+  }
+  tree.ResetBranchAddresses();
+  tree.SetBranchStatus("*",1);
+  return true;
+};
+
+
+bool saveLumiMap(const std::map<int, std::set<int>>& lumiMap, TDirectory& dir)
+{
+  // Store the (run, lumi-section) pairs in a summary tree
+  dir.cd();
+  TTree tree("lumiSummary", "Luminosity sections");
+  int run, lumi;
+  tree.Branch("run", &run, "run/I");
+  tree.Branch("lumi", &lumi, "lumi/I");
+  for (const auto& r : lumiMap) {
+    run = r.first;
+    for (const auto& l : r.second) { lumi = l; tree.Fill(); }
+  }
+  return (tree.Write()>0);
+};
+
+
+bool loadLumiMap(std::map<int, std::set<int>>& lumiMap, TDirectory& dir)
+{
+  lumiMap.clear();
+  auto tree = dynamic_cast<TTree*>(dir.Get("lumiSummary"));
+  if (!tree) { return false; }
+  int run, lumi;
+  tree->SetBranchAddress("run", &run);
+  tree->SetBranchAddress("lumi", &lumi);
+  for (Long64_t i=0; i<tree->GetEntries(); i++) {
+    if (tree->GetEntry(i)<0) { lumiMap.clear(); return false; }
+    lumiMap[run].insert(lumi);
+  }
+  return true;
+};
+
+
+#endif // #ifndef eventIdUtils_h
@@ -84,7 +84,7 @@ void RocRes::dumpParams(){
 	
 void RocRes::init(std::string filename){
     std::ifstream in(filename.c_str());
-    char tag[4];
+    std::string tag;
     int type, sys, mem, isdt, var, bin;	
     std::string s;
     while(std::getline(in, s)){
@@ -248,7 +248,7 @@ void RocOne::init(std::string filename, int iTYPE, int iSYS, int iMEM){
     RR.init(filename);
 
     std::ifstream in(filename.c_str());
-    char tag[4];
+    std::string tag;
     int type, sys, mem, isdt, var, bin;	
 
     bool initialized=false;
@@ -325,6 +325,31 @@ double RocOne::kGenSmear(double pt, double eta, double v, double u, RocRes::TYPE
     return RR.kSmear(pt, eta, TT, v, u);
 }
 
+void RocOne::kScale(int T, int N, const int *Q, const double *pt, const double *eta, const double *phi, double *k) const{
+    const double *m=&M[T][0][0];
+    const double *a=&A[T][0][0];
+    const double *d=D[T];
+    for(int i=0; i<N; ++i){
+	int H=getBin(eta[i], NETA, BETA);
+	int b=H*NMAXPHI+getBin(phi[i], NPHI, MPHI, DPHI);
+	k[i]=d[H]/(m[b]+Q[i]*a[b]*pt[i]);
+    }
+}
+
+void RocOne::kScaleDT(int N, const int *Q, const double *pt, const double *eta, const double *phi, double *k) const{
+    kScale(DT, N, Q, pt, eta, phi, k);
+}
+
+void RocOne::kScaleAndSmearMC(int N, const int *Q, const double *pt, const double *eta, const double *phi, const int *n, const double *u, const double *w, double *k) const{
+    kScale(MC, N, Q, pt, eta, phi, k);
+    for(int i=0; i<N; ++i) k[i]*=RR.kExtra(k[i]*pt[i], eta[i], n[i], u[i], w[i]);
+}
+
+void RocOne::kScaleFromGenMC(int N, const int *Q, const double *pt, const double *eta, const double *phi, const int *n, const double *gt, const double *w, double *k) const{
+    kScale(MC, N, Q, pt, eta, phi, k);
+    for(int i=0; i<N; ++i) k[i]*=RR.kSpread(gt[i], k[i]*pt[i], eta[i], n[i], w[i]);
+}
+
 
 //-------------------------------------
 
@@ -349,18 +374,17 @@ RoccoR::init(std::string dirname){
     while(std::getline(in, s)){
 	std::stringstream ss(s); 
 	ss >> tag >> si >> sn; 
-	std::vector<RocOne> v;
+	RCset.push_back(RC.size());
 	for(int m=0; m<sn; ++m){
 	    std::string inputfile=Form("%s/%d.%d.txt", dirname.c_str(), si, m);
 	    if(gSystem->AccessPathName(inputfile.c_str())) {
 		std::cout << Form("Missing %8d %3d, using default instead...", si, m) << std::endl;  
-		v.push_back(RocOne(Form("%s/%d.%d.txt", dirname.c_str(),0,0),0,0,0));
+		RC.push_back(RocOne(Form("%s/%d.%d.txt", dirname.c_str(),0,0),0,0,0));
 	    }
 	    else{
-		v.push_back(RocOne(inputfile, 0, si, m));
+		RC.push_back(RocOne(inputfile, 0, si, m));
 	    }
 	}
-	RC.push_back(v);
     }
 
     in.close();
@@ -371,19 +395,31 @@ RoccoR::~RoccoR(){}
 
 
 double RoccoR::kGenSmear(double pt, double eta, double v, double u, RocRes::TYPE TT, int s, int m) const{
-    return RC[s][m].kGenSmear(pt, eta, v, u, TT);
+    return getRC(s,m).kGenSmear(pt, eta, v, u, TT);
 }
 
 double RoccoR::kScaleDT(int Q, double pt, double eta, double phi, int s, int m) const{
-    return RC[s][m].kScaleDT(Q, pt, eta, phi);
+    return getRC(s,m).kScaleDT(Q, pt, eta, phi);
 }
 
 double RoccoR::kScaleAndSmearMC(int Q, double pt, double eta, double phi, int n, double u, double w, int s, int m) const{
-    return RC[s][m].kScaleAndSmearMC(Q, pt, eta, phi, n, u, w);
+    return getRC(s,m).kScaleAndSmearMC(Q, pt, eta, phi, n, u, w);
 }
 
 double RoccoR::kScaleFromGenMC(int Q, double pt, double eta, double phi, int n, double gt, double w, int s, int m) const{
-    return RC[s][m].kScaleFromGenMC(Q, pt, eta, phi, n, gt, w);
+    return getRC(s,m).kScaleFromGenMC(Q, pt, eta, phi, n, gt, w);
+}
+
+void RoccoR::kScaleDT(int N, const int *Q, const double *pt, const double *eta, const double *phi, double *k, int s, int m) const{
+    getRC(s,m).kScaleDT(N, Q, pt, eta, phi, k);
+}
+
+void RoccoR::kScaleAndSmearMC(int N, const int *Q, const double *pt, const double *eta, const double *phi, const int *n, const double *u, const double *w, double *k, int s, int m) const{
+    getRC(s,m).kScaleAndSmearMC(N, Q, pt, eta, phi, n, u, w, k);
+}
+
+void RoccoR::kScaleFromGenMC(int N, const int *Q, const double *pt, const double *eta, const double *phi, const int *n, const double *gt, const double *w, double *k, int s, int m) const{
+    getRC(s,m).kScaleFromGenMC(N, Q, pt, eta, phi, n, gt, w, k);
 }
 
 
@@ -168,6 +168,7 @@ class RocOne{
 
 	int getBin(double x, const int NN, const double *b) const;
 	int getBin(double x, const int nmax, const double xmin, const double dx) const;
+	void kScale(int T, int N, const int *Q, const double *pt, const double *eta, const double *phi, double *k) const;
 
     public:
 	enum TYPE{MC, DT};
@@ -187,6 +188,11 @@ class RocOne{
 	double kScaleFromGenMC(int Q, double pt, double eta, double phi, int n, double gt, double w) const;
 	double kGenSmear(double pt, double eta, double v, double u, RocRes::TYPE TT=RocRes::Data) const;
 
+	// batch versions, correcting N muons at once
+	void kScaleDT(int N, const int *Q, const double *pt, const double *eta, const double *phi, double *k) const;
+	void kScaleAndSmearMC(int N, const int *Q, const double *pt, const double *eta, const double *phi, const int *n, const double *u, const double *w, double *k) const;
+	void kScaleFromGenMC(int N, const int *Q, const double *pt, const double *eta, const double *phi, const int *n, const double *gt, const double *w, double *k) const;
+
 	double getM(int T, int H, int F) const{return M[T][H][F];}
 	double getA(int T, int H, int F) const{return A[T][H][F];}
 	double getK(int T, int H) const{return T==DT?RR.getkDat(H):RR.getkRes(H);}
@@ -208,14 +214,23 @@ class RoccoR{
 	double kScaleAndSmearMC(int Q, double pt, double eta, double phi, int n, double u, double w, int s=0, int m=0) const;  
 	double kScaleFromGenMC(int Q, double pt, double eta, double phi, int n, double gt, double w, int s=0, int m=0) const; 
 
+	// batch versions, correcting N muons at once with the error set s and member m
+	void kScaleDT(int N, const int *Q, const double *pt, const double *eta, const double *phi, double *k, int s=0, int m=0) const;
+	void kScaleAndSmearMC(int N, const int *Q, const double *pt, const double *eta, const double *phi, const int *n, const double *u, const double *w, double *k, int s=0, int m=0) const;
+	void kScaleFromGenMC(int N, const int *Q, const double *pt, const double *eta, const double *phi, const int *n, const double *gt, const double *w, double *k, int s=0, int m=0) const;
+
 
-	double getM(int T, int H, int F, int E=0, int m=0) const{return RC[E][m].getM(T,H,F);}
-	double getA(int T, int H, int F, int E=0, int m=0) const{return RC[E][m].getA(T,H,F);}
-	double getK(int T, int H, int E=0, int m=0)        const{return RC[E][m].getK(T,H);}
+	double getM(int T, int H, int F, int E=0, int m=0) const{return getRC(E,m).getM(T,H,F);}
+	double getA(int T, int H, int F, int E=0, int m=0) const{return getRC(E,m).getA(T,H,F);}
+	double getK(int T, int H, int E=0, int m=0)        const{return getRC(E,m).getK(T,H);}
 
-	int Nset() const{return RC.size();}
-	int Nmem(int s=0) const{return RC[s].size();}
+	int Nset() const{return RCset.size();}
+	int Nmem(int s=0) const{return (s+1<Nset() ? RCset[s+1] : int(RC.size())) - RCset[s];}
 
     private:
-	std::vector<std::vector<RocOne> > RC;
+	// members of all error sets in one table, the members of set s start at RCset[s]
+	std::vector<RocOne> RC;
+	std::vector<int> RCset;
+
+	const RocOne& getRC(int s, int m) const{return RC[RCset[s]+m];}
 };
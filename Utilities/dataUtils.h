@@ -10,6 +10,7 @@
 #include "TSystemFile.h"
 #include "TList.h"
 #include "TFile.h"
+#include "TTree.h"
 #include "TH1.h"
 #include "TGraphAsymmErrors.h"
 
@@ -203,6 +204,15 @@ typedef struct GlobalInfo {
 } GlobalInfo;
 
 
+// Fit Summary Record (one row per workspace object, readable without RooFit)
+typedef struct FitSummaryRow_t {
+  std::string kind, name, title, str;
+  double val=-99., err=-99., errLo=-99., errHi=-99., min=-99., max=-99., defMin=-99., defMax=-99., iniVal=-99., iniErr=-99.;
+  bool isConst=false;
+} FitSummaryRow_t;
+typedef std::vector< FitSummaryRow_t > FitSummary_t;
+
+
 // ------------------ FUNCTION -------------------------------
 template<class C, class T>
 inline auto contain_impl(const C& c, const T& x, int)
@@ -272,6 +282,55 @@ bool existFile(const std::string& file)
 };
 
 
+long fileModTime(const std::string& file)
+{
+  struct stat buffer;
+  return ((stat (file.c_str(), &buffer) == 0) ? long(buffer.st_mtime) : -1);
+};
+
+
+std::string fileStamp(const std::string& file)
+{
+  // Modification time and size of a file, used to detect rewritten files
+  struct stat buffer;
+  return ((stat (file.c_str(), &buffer) == 0) ? (std::to_string(long(buffer.st_mtime))+"_"+std::to_string((long long)(buffer.st_size))) : "");
+};
+
+
+bool getFitSummary(FitSummary_t& summary, const std::string& fileName)
+{
+  // Open the fit output file
+  auto file = std::unique_ptr<TFile>(TFile::Open(fileName.c_str(), "READ"));
+  if (!file || !file->IsOpen() || file->IsZombie()) { return false; }
+  // Read the fit summary tree, if it was stored
+  auto tree = dynamic_cast<TTree*>(file->Get("fitSummary"));
+  if (!tree) { file->Close(); return false; }
+  FitSummaryRow_t row;
+  // The string buffers are owned here, not by the tree
+  auto kind = new std::string(), name = new std::string(), title = new std::string(), str = new std::string();
+  tree->SetBranchAddress("kind", &kind); tree->SetBranchAddress("name", &name);
+  tree->SetBranchAddress("title", &title); tree->SetBranchAddress("str", &str);
+  tree->SetBranchAddress("val", &row.val); tree->SetBranchAddress("err", &row.err);
+  tree->SetBranchAddress("errLo", &row.errLo); tree->SetBranchAddress("errHi", &row.errHi);
+  tree->SetBranchAddress("min", &row.min); tree->SetBranchAddress("max", &row.max);
+  tree->SetBranchAddress("defMin", &row.defMin); tree->SetBranchAddress("defMax", &row.defMax);
+  tree->SetBranchAddress("iniVal", &row.iniVal); tree->SetBranchAddress("iniErr", &row.iniErr);
+  tree->SetBranchAddress("isConst", &row.isConst);
+  bool isValid = true;
+  summary.clear();
+  summary.reserve(tree->GetEntries());
+  for (Long64_t i = 0; i < tree->GetEntries(); i++) {
+    if (tree->GetEntry(i)<0) { summary.clear(); isValid = false; break; }
+    row.kind = *kind; row.name = *name; row.title = *title; row.str = *str;
+    summary.push_back(row);
+  }
+  tree->ResetBranchAddresses();
+  delete kind; delete name; delete title; delete str;
+  file->Close();
+  return isValid;
+};
+
+
 void makeDir(const std::string& dir)
 {
   if (existDir(dir)==false){